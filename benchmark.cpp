@@ -0,0 +1,150 @@
+// Benchmark of the scheduling engine: FCFS and RR over synthetic workloads of growing size, reporting events/sec,
+// ns/event and peak RSS for each run, and how fast the text reader loads each workload.
+#include "scheduler.h"
+#include "generator.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+// high-water mark of the resident set of this process so far, in MB (-1 where unknown)
+double peakRssMegabytes(){
+#ifndef _WIN32
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    return usage.ru_maxrss / 1024.0; // kilobytes
+#endif
+#else
+    return -1;
+#endif
+}
+
+// time one simulation of the workload, keeping only streaming metrics like --summary does, and recording its
+// timeline into a ring of timeline records when that's not 0 (allocated before the clock starts)
+void benchmarkRun(const Workload& workload, const char* name, int time_quantum, SchedulingPolicy policy,
+                  const SimulationOptions& options, size_t timeline){
+    ProcessTable processes(workload);
+    StreamingMetrics metrics;
+    processes.metrics = &metrics;
+    processes.keep_records = false;
+    unique_ptr<ExecutionTrace> trace;
+    if(timeline){
+        trace = make_unique<ExecutionTrace>(timeline);
+        processes.trace = trace.get();
+    }
+
+    auto start = chrono::steady_clock::now();
+    simulateProcesses(processes, time_quantum, policy, options);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << left << setw(10) << name << right << setw(14) << processes.events << fixed << setprecision(3) << setw(11) << seconds
+         << setprecision(2) << setw(13) << processes.events / seconds / 1e6 << setprecision(1) << setw(11)
+         << seconds * 1e9 / max(1LL, processes.events) << setw(13) << peakRssMegabytes() << "\n";
+    cout.unsetf(ios::floatfield);
+}
+
+int main(int argc, char* argv[]){
+    long long max_processes = 100000000;
+    int time_quantum = 4;
+    // Poisson arrivals and exponential bursts, close to fully loaded; a 15-unit mean burst keeps 100M processes'
+    // arrival times inside int
+    GeneratorOptions generator;
+    generator.mean_burst = 15;
+    generator.load = 0.95;
+    generator.seed = 42;
+    bool parse = true;
+    size_t timeline = 0;
+    SimulationOptions options;
+    options.switch_cost.fixed = 0; // switching would push the load past 1 and change the workload being timed
+
+    for(int i = 1; i < argc; ++i){
+        if(strcmp(argv[i], "--max-processes") == 0 && i + 1 < argc && atoll(argv[i + 1]) > 0){
+            max_processes = atoll(argv[++i]);
+        }else if(strcmp(argv[i], "--quantum") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            time_quantum = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc){
+            generator.seed = strtoull(argv[++i], nullptr, 10);
+        }else if(strcmp(argv[i], "--calendar-queue") == 0){
+            options.queue_kind = EventQueueKind::CALENDAR;
+        }else if(strcmp(argv[i], "--rr-fast-forward") == 0){
+            options.rr_fast_forward = true;
+        }else if(strcmp(argv[i], "--cores") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            options.cores = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--switch-cost") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 0){
+            options.switch_cost.fixed = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--no-parse") == 0){
+            parse = false;
+#ifndef SCHEDULER_NO_TRACE
+        }else if(strcmp(argv[i], "--timeline") == 0 && i + 1 < argc && atoll(argv[i + 1]) > 0){
+            timeline = static_cast<size_t>(atoll(argv[++i]));
+#endif
+        }else{
+            cout << "Usage: " << argv[0] << " [--max-processes <n>] [--quantum <q>] [--seed <n>] [--calendar-queue]"
+                 << " [--rr-fast-forward] [--cores <n>] [--switch-cost <t>] [--no-parse]"
+                 << " [--timeline <records>]\n";
+            return 1;
+        }
+    }
+
+    string rr_name = "RR q=" + to_string(time_quantum);
+    string text_file = (filesystem::temp_directory_path() / "scheduler_bench_workload.txt").string();
+
+    for(long long num_processes = 1000; num_processes <= max_processes; num_processes *= 10){
+        cout << "== " << num_processes << " processes ==\n";
+        Workload workload;
+        string error;
+        generator.count = num_processes;
+        if(!generateWorkload(generator, workload, error)){
+            cout << "Error: " << error << "\n";
+            return 1;
+        }
+
+        if(parse){
+            // load the workload back through the text reader and simulate what it read
+            if(!writeTextWorkload(workload, text_file)){
+                cout << "Error: cannot write " << text_file << "\n";
+                return 1;
+            }
+            double megabytes = filesystem::file_size(text_file) / (1024.0 * 1024.0);
+            workload = Workload(); // free the generated copy before the parsed one exists
+            auto start = chrono::steady_clock::now();
+            workload = readProcesses(text_file, -1);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            filesystem::remove(text_file);
+            if(static_cast<long long>(workload.size()) != num_processes){
+                cout << "Error: read back " << workload.size() << " of " << num_processes << " processes\n";
+                return 1;
+            }
+            cout << "parse " << fixed << setprecision(1) << megabytes << " MB in " << setprecision(3) << seconds << " s, "
+                 << setprecision(1) << megabytes / seconds << " MB/s, " << setprecision(2) << num_processes / seconds / 1e6
+                 << " M processes/s\n";
+            cout.unsetf(ios::floatfield);
+        }
+
+        cout << left << setw(10) << "policy" << right << setw(14) << "events" << setw(11) << "seconds" << setw(13) << "Mevents/s"
+             << setw(11) << "ns/event" << setw(13) << "peak RSS MB" << "\n";
+        benchmarkRun(workload, "FCFS", -1, SchedulingPolicy::FCFS, options, timeline);
+        benchmarkRun(workload, rr_name.c_str(), time_quantum, SchedulingPolicy::RR, options, timeline);
+        if(options.cores == 1){ // the multi-CPU engine only runs FCFS and RR
+            benchmarkRun(workload, "SJF", -1, SchedulingPolicy::SJF, options, timeline);
+            benchmarkRun(workload, "SRTF", -1, SchedulingPolicy::SRTF, options, timeline);
+            benchmarkRun(workload, "CFS", -1, SchedulingPolicy::CFS, options, timeline);
+            benchmarkRun(workload, "MLFQ", -1, SchedulingPolicy::MLFQ, options, timeline);
+        }
+        cout << "\n";
+    }
+    return 0;
+}
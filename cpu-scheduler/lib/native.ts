@@ -0,0 +1,50 @@
+import path from 'path';
+import { DaemonResult, SimulationRequest } from './simulator-client';
+
+// the engine as a Node addon (node_addon.cpp at the repository root, built by CMake next to the simulator)
+export const SCHEDULER_ADDON = process.env.SCHEDULER_ADDON || path.resolve(process.cwd(), '..', 'build', 'scheduler_node.node');
+
+interface Addon {
+  simulate(options: {
+    policy: string;
+    quantum: number;
+    arrivals: Int32Array;
+    bursts: Int32Array;
+    ids?: Int32Array;
+    summaryOnly?: boolean;
+  }): Promise<DaemonResult>;
+}
+
+let addon: Addon | null | undefined;
+
+// the addon, or null when it hasn't been built; only tried once
+function load(): Addon | null {
+  if (addon === undefined) {
+    try {
+      addon = eval('require')(SCHEDULER_ADDON) as Addon; // hidden from webpack, which can't bundle a .node file
+    } catch (error) {
+      console.error('Scheduler addon unavailable:', (error as Error).message);
+      addon = null;
+    }
+  }
+  return addon;
+}
+
+export function nativeAvailable(): boolean {
+  return load() !== null;
+}
+
+// run one simulation in-process, off the event loop; the arrays are read in place, so leave them alone until
+// the promise settles
+export function simulateNative(request: SimulationRequest): Promise<DaemonResult> {
+  const native = load();
+  if (!native) return Promise.reject(new Error('scheduler addon unavailable'));
+  return native.simulate({
+    policy: request.algorithm,
+    quantum: request.timeQuantum,
+    arrivals: request.arrivals,
+    bursts: request.bursts,
+    ids: request.ids,
+    summaryOnly: request.summaryOnly,
+  });
+}
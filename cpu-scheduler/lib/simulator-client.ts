@@ -0,0 +1,133 @@
+import net from 'net';
+
+// client for the simulator daemon (`main --serve <socket>`, framing described in server.h at the repository root)
+export const SCHEDULER_SOCKET = process.env.SCHEDULER_SOCKET || '/tmp/processpilot.sock';
+
+// SchedulingPolicy order in scheduler.h
+export const POLICIES = ['FCFS', 'RR', 'SJF', 'SRTF', 'CFS', 'MLFQ'];
+
+const SUMMARY_ONLY = 1;
+const STATUS_OK = 0;
+
+export interface SimulationRequest {
+  algorithm: string;
+  timeQuantum: number;
+  ids: Int32Array;
+  arrivals: Int32Array;
+  bursts: Int32Array;
+  summaryOnly?: boolean;
+}
+
+export interface DaemonResult {
+  totalTime: number;
+  avgTurnaroundTime: number;
+  avgWaitingTime: number;
+  avgResponseTime: number;
+  cpuEfficiency: number;
+  // empty with summaryOnly
+  startTime: Int32Array;
+  endTime: Int32Array;
+  turnaroundTime: Int32Array;
+  waitingTime: Int32Array;
+  responseTime: Int32Array;
+}
+
+export type DaemonResponse = DaemonResult | { error: string };
+
+function encode(requests: SimulationRequest[]): Buffer {
+  let size = 4;
+  for (const request of requests) size += 16 + 12 * request.ids.length;
+  const frame = Buffer.allocUnsafe(4 + size);
+  let offset = frame.writeUInt32LE(size, 0);
+  offset = frame.writeUInt32LE(requests.length, offset);
+  for (const request of requests) {
+    const policy = POLICIES.indexOf(request.algorithm);
+    offset = frame.writeUInt32LE(policy < 0 ? 0xffffffff : policy, offset); // the daemon answers an unknown one with an error
+    offset = frame.writeInt32LE(request.timeQuantum | 0, offset);
+    offset = frame.writeUInt32LE(request.summaryOnly ? SUMMARY_ONLY : 0, offset);
+    offset = frame.writeUInt32LE(request.ids.length, offset);
+    for (const column of [request.ids, request.arrivals, request.bursts]) {
+      for (let i = 0; i < column.length; i++) offset = frame.writeInt32LE(column[i], offset);
+    }
+  }
+  return frame;
+}
+
+function decode(payload: Buffer): DaemonResponse[] {
+  const count = payload.readUInt32LE(0);
+  let offset = 4;
+  const column = (n: number) => {
+    const values = new Int32Array(n);
+    for (let i = 0; i < n; i++, offset += 4) values[i] = payload.readInt32LE(offset);
+    return values;
+  };
+  const responses: DaemonResponse[] = [];
+  for (let r = 0; r < count; r++) {
+    const status = payload.readUInt32LE(offset);
+    offset += 4;
+    if (status !== STATUS_OK) {
+      const length = payload.readUInt32LE(offset);
+      responses.push({ error: payload.toString('utf8', offset + 4, offset + 4 + length) });
+      offset += 4 + length;
+      continue;
+    }
+    const totalTime = Number(payload.readBigInt64LE(offset));
+    const avgTurnaroundTime = payload.readDoubleLE(offset + 8);
+    const avgWaitingTime = payload.readDoubleLE(offset + 16);
+    const avgResponseTime = payload.readDoubleLE(offset + 24);
+    const cpuEfficiency = payload.readDoubleLE(offset + 32);
+    const n = payload.readUInt32LE(offset + 40);
+    offset += 44;
+    responses.push({
+      totalTime, avgTurnaroundTime, avgWaitingTime, avgResponseTime, cpuEfficiency,
+      startTime: column(n), endTime: column(n), turnaroundTime: column(n), waitingTime: column(n), responseTime: column(n),
+    });
+  }
+  return responses;
+}
+
+interface Pending {
+  resolve: (responses: DaemonResponse[]) => void;
+  reject: (error: Error) => void;
+}
+
+// one socket shared by every API call; the daemon answers frames in order, so replies match the pending queue
+let connection: net.Socket | null = null;
+let pending: Pending[] = [];
+let received = Buffer.alloc(0);
+
+function fail(error: Error) {
+  const waiting = pending;
+  pending = [];
+  received = Buffer.alloc(0);
+  connection = null;
+  waiting.forEach(call => call.reject(error));
+}
+
+function connect(): net.Socket {
+  if (connection) return connection;
+  const socket = net.createConnection(SCHEDULER_SOCKET);
+  socket.on('data', chunk => {
+    received = received.length ? Buffer.concat([received, chunk]) : chunk;
+    while (received.length >= 4 && received.length >= 4 + received.readUInt32LE(0)) {
+      const length = received.readUInt32LE(0);
+      const payload = received.subarray(4, 4 + length);
+      received = received.subarray(4 + length);
+      const call = pending.shift();
+      if (call) call.resolve(decode(payload));
+    }
+  });
+  socket.on('error', error => fail(error));
+  socket.on('close', () => fail(new Error('simulator daemon closed the connection')));
+  connection = socket;
+  return socket;
+}
+
+// run a batch of simulations on the daemon; responses come back in request order
+export function simulateBatch(requests: SimulationRequest[]): Promise<DaemonResponse[]> {
+  return new Promise((resolve, reject) => {
+    const socket = connect();
+    pending.push({ resolve, reject });
+    socket.write(encode(requests));
+  });
+}
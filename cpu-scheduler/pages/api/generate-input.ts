@@ -1,24 +1,43 @@
 import { NextApiRequest, NextApiResponse } from 'next';
-import { GoogleGenerativeAI } from "@google/generative-ai";
-import { PromptTemplate } from "@langchain/core/prompts";
-const genAI = new GoogleGenerativeAI(process.env.GOOGLE_API_KEY as string);
+import { execFile } from 'child_process';
+import path from 'path';
 
-export default async function handler(req: NextApiRequest, res: NextApiResponse) {
-  try {
-    const model = genAI.getGenerativeModel({ model: "gemini-pro" });
+// native simulator binary, built with CMake from the repository root (see the top-level README)
+const SCHEDULER_BIN = process.env.SCHEDULER_BIN || path.resolve(process.cwd(), '..', 'build', 'main');
 
-    const prompt = new PromptTemplate({
-      template: "Generate {count} processes for CPU scheduling simulation. Each line should contain exactly 3 space-separated integers: Process ID, Arrival Time, and Burst Time. Process IDs should be sequential starting from 1. Arrival times should be non-decreasing. Burst times should be realistic for CPU processes (between 1 and 100 time units). The output should be exactly {count} lines, each in the format 'ID ArrivalTime BurstTime'.",
-      inputVariables: ["count"],
-    });
+const ARRIVALS = ['poisson', 'mmpp', 'diurnal'];
+const BURSTS = ['exponential', 'pareto', 'bimodal'];
+const MAX_COUNT = 100000; // the text goes back to the browser, keep it to a size a textarea can hold
 
-    const input = await prompt.format({ count: 50 });
-    const result = await model.generateContent(input);
-    const text = result.response.text();
+function pick(value: string | string[] | undefined, allowed: string[], fallback: string): string {
+  return typeof value === 'string' && allowed.includes(value) ? value : fallback;
+}
 
-    res.status(200).json({ processes: text.trim() });
-  } catch (error) {
-    console.error('Error generating input:', error);
-    res.status(500).json({ error: 'Failed to generate input' });
-  }
-}
\ No newline at end of file
+function positiveNumber(value: string | string[] | undefined, fallback: number): number {
+  const parsed = Number(value);
+  return typeof value === 'string' && Number.isFinite(parsed) && parsed > 0 ? parsed : fallback;
+}
+
+export default function handler(req: NextApiRequest, res: NextApiResponse) {
+  const count = Math.min(Math.floor(positiveNumber(req.query.count, 50)), MAX_COUNT);
+  const seed = Math.floor(positiveNumber(req.query.seed, Math.floor(Math.random() * 2 ** 31) + 1));
+  const args = [
+    '--generate', String(count), '-',
+    '--arrivals', pick(req.query.arrivals, ARRIVALS, 'poisson'),
+    '--bursts', pick(req.query.bursts, BURSTS, 'exponential'),
+    '--mean-burst', String(positiveNumber(req.query.meanBurst, 20)),
+    '--load', String(positiveNumber(req.query.load, 0.9)),
+    '--seed', String(seed),
+  ];
+
+  execFile(SCHEDULER_BIN, args, { maxBuffer: 64 * 1024 * 1024 }, (error, stdout, stderr) => {
+    if (error) {
+      console.error('Error generating input:', stderr || error.message);
+      res.status(500).json({ error: 'Failed to generate input' });
+      return;
+    }
+    // drop the count header line, the simulate endpoint takes one process per line
+    const lines = stdout.trim().split('\n').slice(1);
+    res.status(200).json({ processes: lines.join('\n'), seed });
+  });
+}
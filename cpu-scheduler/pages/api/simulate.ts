@@ -1,24 +1,87 @@
 import { NextApiRequest, NextApiResponse } from 'next';
 import { runFCFS, runRR } from '../../lib/scheduler';
+import { DaemonResult, POLICIES, SimulationRequest, simulateBatch } from '../../lib/simulator-client';
+import { nativeAvailable, simulateNative } from '../../lib/native';
 
-export default function handler(req: NextApiRequest, res: NextApiResponse) {
+// a million processes of text is ~15 MB
+export const config = { api: { bodyParser: { sizeLimit: '64mb' } } };
+
+const MAX_ROWS = 1000; // per-process rows sent back; the averages always cover every process
+
+// "id arrival burst" lines straight into columns, without an object per process
+function parseColumns(text: string) {
+  const lines = text.trim().split('\n');
+  const ids = new Int32Array(lines.length);
+  const arrivals = new Int32Array(lines.length);
+  const bursts = new Int32Array(lines.length);
+  lines.forEach((line, i) => {
+    const [id, arrivalTime, burstTime] = line.trim().split(/\s+/).map(Number);
+    ids[i] = id;
+    arrivals[i] = arrivalTime;
+    bursts[i] = burstTime;
+  });
+  return { ids, arrivals, bursts };
+}
+
+function toResponse(request: SimulationRequest, result: DaemonResult) {
+  const { startTime, endTime, turnaroundTime, waitingTime, responseTime, ...averages } = result;
+  const rows = Math.min(request.ids.length, MAX_ROWS);
+  const processes = [];
+  for (let i = 0; i < rows; i++) {
+    processes.push({
+      id: request.ids[i],
+      arrivalTime: request.arrivals[i],
+      burstTime: request.bursts[i],
+      remainingTime: 0,
+      startTime: startTime[i],
+      endTime: endTime[i],
+      turnaroundTime: turnaroundTime[i],
+      waitingTime: waitingTime[i],
+      responseTime: responseTime[i],
+    });
+  }
+  return { ...averages, processCount: request.ids.length, processes };
+}
+
+export default async function handler(req: NextApiRequest, res: NextApiResponse) {
   if (req.method === 'POST') {
     const { algorithm, processes, timeQuantum } = req.body;
 
-    const parsedProcesses = processes.trim().split('\n').map((line: string) => {
-      const [id, arrivalTime, burstTime] = line.trim().split(/\s+/).map(Number);
-      return { 
-        id, 
-        arrivalTime, 
-        burstTime, 
-        remainingTime: burstTime, 
-        startTime: 0, 
-        endTime: 0, 
-        turnaroundTime: 0, 
-        waitingTime: 0, 
-        responseTime: 0 
-      };
-    });
+    if (!POLICIES.includes(algorithm)) {
+      return res.status(400).json({ error: 'Invalid algorithm' });
+    }
+    const request: SimulationRequest = { algorithm, timeQuantum: Number(timeQuantum) || 0, ...parseColumns(processes) };
+
+    // the C++ engine, in-process through the addon or else from the simulator daemon; without either, FCFS and
+    // RR fall back to the TypeScript versions
+    try {
+      if (nativeAvailable()) {
+        return res.status(200).json(toResponse(request, await simulateNative(request)));
+      }
+    } catch (error) {
+      return res.status(400).json({ error: (error as Error).message });
+    }
+    try {
+      const [response] = await simulateBatch([request]);
+      if ('error' in response) {
+        return res.status(400).json({ error: response.error });
+      }
+      return res.status(200).json(toResponse(request, response));
+    } catch (error) {
+      console.error('Simulator daemon unavailable:', (error as Error).message);
+    }
+
+    const parsedProcesses = Array.from(request.ids, (id, i) => ({
+      id,
+      arrivalTime: request.arrivals[i],
+      burstTime: request.bursts[i],
+      remainingTime: request.bursts[i],
+      startTime: 0,
+      endTime: 0,
+      turnaroundTime: 0,
+      waitingTime: 0,
+      responseTime: 0
+    }));
 
     let result;
     if (algorithm === 'FCFS') {
@@ -26,7 +89,7 @@ export default function handler(req: NextApiRequest, res: NextApiResponse) {
     } else if (algorithm === 'RR') {
       result = runRR(parsedProcesses, timeQuantum);
     } else {
-      return res.status(400).json({ error: 'Invalid algorithm' });
+      return res.status(503).json({ error: `${algorithm} needs the scheduler addon or daemon` });
     }
 
     res.status(200).json(result);
@@ -34,4 +97,4 @@ export default function handler(req: NextApiRequest, res: NextApiResponse) {
     res.setHeader('Allow', ['POST']);
     res.status(405).end(`Method ${req.method} Not Allowed`);
   }
-}
\ No newline at end of file
+}
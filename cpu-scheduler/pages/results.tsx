@@ -18,6 +18,7 @@ interface SimulationResult {
   avgWaitingTime: number;
   avgResponseTime: number;
   cpuEfficiency: number;
+  processCount?: number; // processes simulated, when the engine ran them and processes holds only the first rows
   processes: Process[];
 }
 
@@ -60,6 +61,9 @@ export default function Results() {
           <p>Response Time: {formatNumber(results.avgResponseTime)} units</p>
         </div>
       </div>
+      {results.processCount !== undefined && results.processCount > results.processes.length && (
+        <p className="mb-2">Showing the first {results.processes.length} of {results.processCount} processes.</p>
+      )}
       <div className="overflow-x-auto">
         <table className="w-full border-collapse border">
           <thead>
@@ -0,0 +1,118 @@
+#include "ensemble.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+
+// Replicas are handed out in chunks, each with its own accumulators, merged in chunk order at the end. The
+// chunking only depends on the replica count, so the merged numbers come out the same on any number of threads.
+const long long ENSEMBLE_CHUNKS = 4096;
+
+// two-sided 95% quantile of Student's t with df degrees of freedom: a table for small df, the Cornish-Fisher
+// expansion around the normal quantile beyond it
+double studentT95(long long df){
+    static const double TABLE[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if(df <= 30) return TABLE[max(1LL, df) - 1];
+    const double z = 1.959964;
+    double n = static_cast<double>(df);
+    return z + (z * z * z + z) / (4 * n) + (5 * pow(z, 5) + 16 * z * z * z + 3 * z) / (96 * n * n);
+}
+
+double RunningStat::ci95() const{
+    return count > 1 ? studentT95(count - 1) * sqrt(variance() / count) : 0.0;
+}
+
+bool runEnsemble(const EnsembleOptions& options, const SimulationOptions& simulation, EnsembleResult& result, string& error){
+    if(options.replicas <= 0){
+        error = "an ensemble needs at least one replica";
+        return false;
+    }
+    if(options.workload.count <= 0 || options.workload.count > numeric_limits<int>::max()){
+        error = "process count must be between 1 and " + to_string(numeric_limits<int>::max());
+        return false;
+    }
+    vector<SchedulingPolicy> policies = options.policies;
+    if(policies.empty()){
+        Workload nothing;
+        ProcessTable none(nothing);
+        for(int p = 0; p < POLICY_COUNT; ++p){
+            if(!unsupportedRun(none, static_cast<SchedulingPolicy>(p), simulation)) policies.push_back(static_cast<SchedulingPolicy>(p));
+        }
+    }
+
+    long long chunk_size = (options.replicas + ENSEMBLE_CHUNKS - 1) / ENSEMBLE_CHUNKS;
+    size_t chunks = static_cast<size_t>((options.replicas + chunk_size - 1) / chunk_size);
+    vector<vector<EnsemblePolicyStats>> partial(chunks); // one accumulator set per chunk, written by one thread
+    atomic<bool> failed(false);
+    string first_error;
+    mutex error_lock;
+
+    WorkStealingPool pool(options.threads ? options.threads : thread::hardware_concurrency());
+    auto start = chrono::steady_clock::now();
+    pool.run(chunks, [&](size_t chunk){
+        vector<EnsemblePolicyStats>& stats = partial[chunk];
+        for(SchedulingPolicy policy : policies) stats.push_back(EnsemblePolicyStats{policy, {}, {}, {}, {}, {}});
+        Workload workload;
+        StreamingMetrics metrics;
+        string replica_error;
+        long long first = static_cast<long long>(chunk) * chunk_size;
+        for(long long replica = first; replica < min(options.replicas, first + chunk_size) && !failed; ++replica){
+            GeneratorOptions generator = options.workload;
+            generator.seed = RandomStream(options.workload.seed, static_cast<uint64_t>(replica)).next(); // its own streams
+            if(!generateWorkload(generator, workload, replica_error, 1)){
+                lock_guard<mutex> lock(error_lock);
+                if(!failed.exchange(true)) first_error = "replica " + to_string(replica) + ": " + replica_error;
+                return;
+            }
+            for(EnsemblePolicyStats& policy_stats : stats){
+                ProcessTable processes(workload); // private run state, shared input columns
+                processes.metrics = &metrics;
+                processes.keep_records = false;
+                long long total_execution_time = simulateProcesses(processes, options.time_quantum, policy_stats.policy, simulation);
+                policy_stats.avg_tat.add(metrics.mean(metrics.total_tat));
+                policy_stats.p99_tat.add(static_cast<double>(metrics.turnaround.percentile(99)));
+                policy_stats.avg_wt.add(metrics.mean(metrics.total_wt));
+                policy_stats.avg_rt.add(metrics.mean(metrics.total_rt));
+                policy_stats.cpu_efficiency.add(100.0 * total_execution_time / max(1LL, total_execution_time + processes.switch_time));
+            }
+        }
+    });
+    if(failed){
+        error = first_error;
+        return false;
+    }
+
+    result = EnsembleResult();
+    for(SchedulingPolicy policy : policies) result.policies.push_back(EnsemblePolicyStats{policy, {}, {}, {}, {}, {}});
+    for(const auto& stats : partial){
+        for(size_t p = 0; p < stats.size(); ++p) result.policies[p].merge(stats[p]);
+    }
+    result.replicas = options.replicas;
+    result.threads = pool.size();
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void displayEnsemble(const EnsembleOptions& options, const EnsembleResult& result){
+    cout << result.replicas << " replicas of " << options.workload.count << " processes, RR quantum "
+         << options.time_quantum << "; mean over replicas +/- 95% confidence interval\n";
+    cout << left << setw(8) << "policy" << right << setw(12) << "avg TAT" << setw(10) << "+/-" << setw(12) << "p99 TAT"
+         << setw(10) << "+/-" << setw(12) << "avg WT" << setw(10) << "+/-" << setw(12) << "avg RT" << setw(10) << "+/-"
+         << setw(10) << "CPU eff%" << "\n";
+    cout << fixed << setprecision(2);
+    for(const auto& stats : result.policies){
+        cout << left << setw(8) << policyName(stats.policy) << right;
+        for(const RunningStat* stat : {&stats.avg_tat, &stats.p99_tat, &stats.avg_wt, &stats.avg_rt}){
+            cout << setw(12) << stat->mean << setw(10) << stat->ci95();
+        }
+        cout << setw(10) << stats.cpu_efficiency.mean << "\n";
+    }
+    cout << result.replicas << " replicas x " << result.policies.size() << " policies on " << result.threads
+         << " threads in " << setprecision(3) << result.seconds << " s (" << setprecision(1)
+         << result.replicas / max(result.seconds, 1e-9) << " replicas/s)\n";
+    cout.unsetf(ios::floatfield);
+}
@@ -0,0 +1,78 @@
+// Monte Carlo ensembles: many generated replicas of one kind of workload, each simulated under every policy, with
+// the spread of the per-replica results turned into confidence intervals. One input.txt is a single sample; an
+// ensemble says how much of a difference between policies is the policy and how much is that sample.
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "generator.h"
+#include "scheduler.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+struct EnsembleOptions{
+    long long replicas = 1000;
+    GeneratorOptions workload; // every replica is drawn from this, under its own seed derived from workload.seed
+    int time_quantum = 4; // RR's quantum
+    std::vector<SchedulingPolicy> policies; // empty for every policy the simulation options support
+    unsigned threads = 0; // 0 for one per core
+};
+
+// Running mean and variance of one statistic across replicas (Welford). Accumulators filled on different threads
+// merge exactly (Chan et al.), so no replica's numbers are ever shared while they are being produced.
+struct RunningStat{
+    long long count = 0;
+    double mean = 0, m2 = 0;
+
+    void add(double value){
+        ++count;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+
+    void merge(const RunningStat& other){
+        if(other.count == 0) return;
+        long long total = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        count = total;
+    }
+
+    double variance() const{ return count > 1 ? m2 / (count - 1) : 0.0; }
+
+    // half the width of the 95% confidence interval of the mean (Student's t), 0 with fewer than two samples
+    double ci95() const;
+};
+
+// per-replica statistics of one policy, accumulated over the replicas
+struct EnsemblePolicyStats{
+    SchedulingPolicy policy;
+    RunningStat avg_tat, p99_tat, avg_wt, avg_rt, cpu_efficiency;
+
+    void merge(const EnsemblePolicyStats& other){
+        avg_tat.merge(other.avg_tat);
+        p99_tat.merge(other.p99_tat);
+        avg_wt.merge(other.avg_wt);
+        avg_rt.merge(other.avg_rt);
+        cpu_efficiency.merge(other.cpu_efficiency);
+    }
+};
+
+struct EnsembleResult{
+    std::vector<EnsemblePolicyStats> policies;
+    long long replicas = 0;
+    unsigned threads = 0;
+    double seconds = 0;
+};
+
+// Generate options.replicas workloads and simulate each under every policy, spread over the cores. Replica r is
+// generated from its own random streams, so the result only depends on the seed, not on the thread count.
+// Fails, with error set, when the generator options are invalid.
+bool runEnsemble(const EnsembleOptions& options, const SimulationOptions& simulation, EnsembleResult& result,
+                 std::string& error);
+void displayEnsemble(const EnsembleOptions& options, const EnsembleResult& result);
+
+#endif // ENSEMBLE_H
@@ -0,0 +1,182 @@
+#include "generator.h"
+
+#include <atomic>
+#include <cmath>
+
+using namespace std;
+
+const size_t GENERATOR_BLOCK = 1 << 16; // processes per block; every block has its own random streams
+
+// MMPP: the bursty state runs at MMPP_BURSTY_RATE x the mean rate for a fifth of the time, the quiet state at
+// MMPP_QUIET_RATE x for the rest, which averages out to the mean rate. A bursty spell lasts about
+// MMPP_BURST_ARRIVALS arrivals.
+const double MMPP_BURSTY_SHARE = 0.2;
+const double MMPP_BURSTY_RATE = 3.0;
+const double MMPP_QUIET_RATE = (1.0 - MMPP_BURSTY_SHARE * MMPP_BURSTY_RATE) / (1.0 - MMPP_BURSTY_SHARE);
+const double MMPP_BURST_ARRIVALS = 100;
+
+// DIURNAL: rate(t) = mean rate * (1 + DIURNAL_AMPLITUDE * sin(2 pi t / day)), with about DIURNAL_DAY_ARRIVALS
+// arrivals per day
+const double DIURNAL_AMPLITUDE = 0.8;
+const double DIURNAL_DAY_ARRIVALS = 10000;
+const double PI = 3.14159265358979323846;
+
+const double PARETO_ALPHA = 1.5; // finite mean, infinite variance
+const double MAX_BURST_FACTOR = 1000; // longest burst, as a multiple of the mean; keeps the Pareto tail in range
+
+// gaps between arrivals of one block, drawn from the block's own stream
+class ArrivalStream{
+public:
+    ArrivalStream(const GeneratorOptions& options, uint64_t block):
+      rng(options.seed, 2 * block), kind(options.arrivals), rate(options.load / options.mean_burst){
+        if(kind == ArrivalProcess::MMPP){
+            // start in the state the chain is in at a random moment, so blocks join up without a seam
+            bursty = rng.uniform() <= MMPP_BURSTY_SHARE;
+            until_switch = rng.exponential(sojourn());
+        }
+    }
+
+    // for DIURNAL these are gaps at the mean rate, bent onto the daily cycle afterwards by diurnalTime()
+    double nextGap(){
+        if(kind != ArrivalProcess::MMPP) return rng.exponential(1.0 / rate);
+        double gap = 0;
+        while(true){
+            double arrival = rng.exponential(1.0 / (rate * (bursty ? MMPP_BURSTY_RATE : MMPP_QUIET_RATE)));
+            if(arrival < until_switch){
+                until_switch -= arrival;
+                return gap + arrival;
+            }
+            // the state flips first; exponential gaps are memoryless, so the next arrival is drawn afresh
+            gap += until_switch;
+            bursty = !bursty;
+            until_switch = rng.exponential(sojourn());
+        }
+    }
+
+private:
+    RandomStream rng;
+    ArrivalProcess kind;
+    double rate;
+    bool bursty = false;
+    double until_switch = 0;
+
+    double sojourn() const{
+        double bursty_time = MMPP_BURST_ARRIVALS / (rate * MMPP_BURSTY_RATE);
+        return bursty ? bursty_time : bursty_time * (1.0 - MMPP_BURSTY_SHARE) / MMPP_BURSTY_SHARE;
+    }
+};
+
+// Time t by which the diurnal process has had as many arrivals as a constant-rate one has by u, i.e. the
+// solution of g(t) = t + A/w * (1 - cos(w t)) = u. g is increasing with g(t) - t in [0, 2A/w], so t lies in
+// [u - 2A/w, u]; Newton steps that leave that bracket fall back to bisection.
+double diurnalTime(double u, double day){
+    const double omega = 2 * PI / day, a = DIURNAL_AMPLITUDE;
+    double lo = max(0.0, u - 2 * a / omega), hi = u, t = u;
+    for(int i = 0; i < 60; ++i){
+        double f = t + a / omega * (1 - cos(omega * t)) - u;
+        if(fabs(f) < 1e-4) break; // arrival times are truncated to whole time units anyway
+        (f > 0 ? hi : lo) = t;
+        double next = t - f / (1 + a * sin(omega * t));
+        t = next > lo && next < hi ? next : (lo + hi) / 2;
+    }
+    return t;
+}
+
+int drawBurst(RandomStream& rng, BurstDistribution kind, double mean){
+    double burst;
+    switch(kind){
+        case BurstDistribution::PARETO:{
+            double scale = mean * (PARETO_ALPHA - 1) / PARETO_ALPHA; // smallest burst, gives the requested mean
+            burst = scale * pow(rng.uniform(), -1.0 / PARETO_ALPHA);
+            break;
+        }
+        case BurstDistribution::BIMODAL:{
+            // 80% short bursts around s, 20% long ones around 10 s, with 0.8 s + 0.2 * 10 s = mean
+            double shortest = mean / 2.8;
+            double center = rng.uniform() <= 0.8 ? shortest : 10 * shortest;
+            burst = center * (0.5 + rng.uniform());
+            break;
+        }
+        default:
+            burst = rng.exponential(mean);
+    }
+    return static_cast<int>(max(1.0, min({round(burst), mean * MAX_BURST_FACTOR, 1e9})));
+}
+
+bool generateWorkload(const GeneratorOptions& options, Workload& out, string& error, unsigned threads){
+    if(options.count <= 0 || options.count > numeric_limits<int>::max()){
+        error = "process count must be between 1 and " + to_string(numeric_limits<int>::max());
+        return false;
+    }
+    if(!(options.mean_burst > 0) || !(options.load > 0)){
+        error = "mean burst and load must be positive";
+        return false;
+    }
+
+    size_t count = static_cast<size_t>(options.count);
+    size_t blocks = (count + GENERATOR_BLOCK - 1) / GENERATOR_BLOCK;
+    double day = DIURNAL_DAY_ARRIVALS * options.mean_burst / options.load;
+    // a single block, or a caller that is itself one of many threads, generates on the calling thread
+    unique_ptr<WorkStealingPool> pool;
+    if(blocks > 1 && threads != 1) pool.reset(new WorkStealingPool(threads ? threads : thread::hardware_concurrency()));
+    auto for_each_block = [&](const function<void(size_t)>& body){
+        if(pool) pool->run(blocks, body);
+        else for(size_t block = 0; block < blocks; ++block) body(block);
+    };
+
+    // pass 1: how much time each block's arrivals span, so every block knows where it starts
+    vector<double> start(blocks + 1, 0.0);
+    for_each_block([&](size_t block){
+        ArrivalStream arrivals(options, block);
+        size_t rows = min(GENERATOR_BLOCK, count - block * GENERATOR_BLOCK);
+        double span = 0;
+        for(size_t i = 0; i < rows; ++i) span += arrivals.nextGap();
+        start[block + 1] = span;
+    });
+    for(size_t block = 0; block < blocks; ++block) start[block + 1] += start[block];
+
+    // pass 2: replay the same streams from each block's start and fill the columns in place
+    int *ids, *arrival_time, *burst_time;
+    out = Workload();
+    out.resize(count, ids, arrival_time, burst_time);
+    atomic<bool> overflow(false);
+    for_each_block([&](size_t block){
+        ArrivalStream arrivals(options, block);
+        RandomStream bursts(options.seed, 2 * block + 1);
+        size_t first = block * GENERATOR_BLOCK, last = min(count, first + GENERATOR_BLOCK);
+        double time = start[block];
+        for(size_t i = first; i < last; ++i){
+            double arrival = options.arrivals == ArrivalProcess::DIURNAL ? diurnalTime(time, day) : time;
+            if(arrival >= numeric_limits<int>::max()){
+                overflow = true;
+                return;
+            }
+            ids[i] = static_cast<int>(i + 1);
+            arrival_time[i] = static_cast<int>(arrival);
+            burst_time[i] = drawBurst(bursts, options.bursts, options.mean_burst);
+            time += arrivals.nextGap();
+        }
+    });
+    if(overflow){
+        error = "arrival times do not fit in an int; use fewer processes, a shorter mean burst or a higher load";
+        out = Workload();
+        return false;
+    }
+    return true;
+}
+
+bool parseArrivalProcess(const string& name, ArrivalProcess& arrivals){
+    if(name == "poisson") arrivals = ArrivalProcess::POISSON;
+    else if(name == "mmpp") arrivals = ArrivalProcess::MMPP;
+    else if(name == "diurnal") arrivals = ArrivalProcess::DIURNAL;
+    else return false;
+    return true;
+}
+
+bool parseBurstDistribution(const string& name, BurstDistribution& bursts){
+    if(name == "exponential") bursts = BurstDistribution::EXPONENTIAL;
+    else if(name == "pareto") bursts = BurstDistribution::PARETO;
+    else if(name == "bimodal") bursts = BurstDistribution::BIMODAL;
+    else return false;
+    return true;
+}
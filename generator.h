@@ -0,0 +1,65 @@
+// Seeded synthetic workloads: an arrival process and a burst distribution, generated in parallel blocks that each
+// draw from their own random streams, so the same seed gives the same workload on any number of threads.
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include "scheduler.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+enum class ArrivalProcess{
+    POISSON, // exponential gaps at a constant rate
+    MMPP, // Markov-modulated Poisson: switches between a bursty and a quiet rate
+    DIURNAL // Poisson with a rate that rises and falls sinusoidally over a "day"
+};
+
+enum class BurstDistribution{
+    EXPONENTIAL,
+    PARETO, // heavy tail: a few huge jobs among many small ones
+    BIMODAL // a mix of short interactive bursts and long batch bursts
+};
+
+struct GeneratorOptions{
+    long long count = 50; // number of processes
+    ArrivalProcess arrivals = ArrivalProcess::POISSON;
+    BurstDistribution bursts = BurstDistribution::EXPONENTIAL;
+    double mean_burst = 20; // mean burst time, in time units
+    double load = 0.9; // offered CPU load: the arrival rate is load / mean_burst
+    uint64_t seed = 1;
+};
+
+// Small, fast random stream (splitmix64). Streams with different ids under one seed are independent for all
+// practical purposes, which is what lets every block of a workload be drawn on any thread.
+class RandomStream{
+public:
+    RandomStream(uint64_t seed, uint64_t stream){
+        state = seed;
+        state = next() ^ (stream * 0xD1B54A32D192ED03ULL);
+        next();
+    }
+
+    uint64_t next(){
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    double uniform(){ return ((next() >> 11) + 1) * 0x1.0p-53; } // in (0, 1]
+
+    double exponential(double mean){ return -mean * std::log(uniform()); }
+
+private:
+    uint64_t state;
+};
+
+// fill out with options.count processes on threads threads (0 for one per core); fails (with error set) when the
+// arrival times would not fit in an int
+bool generateWorkload(const GeneratorOptions& options, Workload& out, std::string& error, unsigned threads = 0);
+
+bool parseArrivalProcess(const std::string& name, ArrivalProcess& arrivals);
+bool parseBurstDistribution(const std::string& name, BurstDistribution& bursts);
+
+#endif // GENERATOR_H
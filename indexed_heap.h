@@ -0,0 +1,148 @@
+// Indexed d-ary min-heap over dense integer items (process indices, event slots). A position map from item to
+// heap slot makes contains() O(1) and lets any item's key be changed (decrease-key or increase-key) or the item
+// removed outright in O(log n), so nothing has to be left behind in the heap to be skipped later.
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+template<class Key, int D = 4>
+class IndexedDaryHeap{
+public:
+    static_assert(D >= 2, "a heap needs at least two children per node");
+
+    bool empty() const{ return heap.empty(); }
+    size_t size() const{ return heap.size(); }
+    bool contains(int item) const{ return item < static_cast<int>(position.size()) && position[item] != NOT_IN_HEAP; }
+
+    // item with the smallest key, and that key
+    int top() const{ return heap[0].item; }
+    const Key& topKey() const{ return heap[0].key; }
+    const Key& key(int item) const{ return heap[position[item]].key; }
+
+    // make room in the position map for items below n up front
+    void reserveItems(size_t n){
+        if(n > position.size()) position.resize(n, NOT_IN_HEAP);
+    }
+
+    void push(int item, const Key& key){
+        reserveItems(static_cast<size_t>(item) + 1);
+        heap.push_back(Entry{key, item});
+        siftUp(heap.size() - 1);
+    }
+
+    // Bottom-up: walk the hole at the root down along the smallest children to a leaf, then drop the last entry
+    // in there and sift it up. The last entry almost always belongs near the bottom, so this saves comparing it
+    // against every level on the way down.
+    int pop(){
+        int item = heap[0].item;
+        position[item] = NOT_IN_HEAP;
+        Entry last = heap.back();
+        heap.pop_back();
+        size_t n = heap.size();
+        if(n == 0) return item;
+        size_t i = 0;
+        while(true){
+            size_t first = i * D + 1;
+            if(first >= n) break;
+            size_t end = first + D < n ? first + D : n;
+            size_t best = first;
+            for(size_t c = first + 1; c < end; ++c){
+                if(heap[c].key < heap[best].key) best = c;
+            }
+            place(i, heap[best]);
+            i = best;
+        }
+        heap[i] = last;
+        siftUp(i);
+        return item;
+    }
+
+    // new key for an item already in the heap, smaller or larger
+    void update(int item, const Key& key){
+        size_t i = position[item];
+        bool smaller = key < heap[i].key;
+        heap[i].key = key;
+        if(smaller) siftUp(i);
+        else siftDown(i);
+    }
+
+    void erase(int item){ removeAt(position[item]); }
+
+    // every item, smallest key first: the order pop() would hand them out in, without popping (O(n log n))
+    std::vector<int> itemsInOrder() const{
+        std::vector<Entry> entries(heap);
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b){ return a.key < b.key; });
+        std::vector<int> items;
+        items.reserve(entries.size());
+        for(const Entry& entry : entries) items.push_back(entry.item);
+        return items;
+    }
+
+    void clear(){
+        for(const Entry& entry : heap) position[entry.item] = NOT_IN_HEAP;
+        heap.clear();
+    }
+
+private:
+    static constexpr int NOT_IN_HEAP = -1;
+
+    struct Entry{
+        Key key;
+        int item;
+    };
+
+    std::vector<Entry> heap;
+    std::vector<int> position; // heap slot of each item, NOT_IN_HEAP when absent
+
+    void place(size_t i, const Entry& entry){
+        heap[i] = entry;
+        position[entry.item] = static_cast<int>(i);
+    }
+
+    void removeAt(size_t i){
+        position[heap[i].item] = NOT_IN_HEAP;
+        Entry last = heap.back();
+        heap.pop_back();
+        if(i == heap.size()) return;
+        bool smaller = last.key < heap[i].key;
+        place(i, last);
+        if(smaller) siftUp(i);
+        else siftDown(i);
+    }
+
+    // move the entry at i up past larger parents, shifting them down into the hole
+    void siftUp(size_t i){
+        Entry entry = heap[i];
+        while(i > 0){
+            size_t parent = (i - 1) / D;
+            if(!(entry.key < heap[parent].key)) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, entry);
+    }
+
+    // move the entry at i down past smaller children
+    void siftDown(size_t i){
+        Entry entry = heap[i];
+        size_t n = heap.size();
+        while(true){
+            size_t first = i * D + 1;
+            if(first >= n) break;
+            size_t last = first + D < n ? first + D : n;
+            size_t best = first;
+            for(size_t c = first + 1; c < last; ++c){
+                if(heap[c].key < heap[best].key) best = c;
+            }
+            if(!(heap[best].key < entry.key)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, entry);
+    }
+};
+
+#endif // INDEXED_HEAP_H
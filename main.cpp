@@ -1,253 +1,490 @@
-#include <algorithm>
-#include <fstream>
-#include <iostream>
-#include <queue>
-#include <vector>
+#include "scheduler.h"
+#include "ensemble.h"
+#include "generator.h"
+#include "server.h"
+#include "snapshot.h"
+#include "trace_import.h"
+
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
-#include <map>
 #include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
 
 using namespace std;
 
-// event types for the CPU scheduling simulation
-enum class EventType{ARRIVAL, COMPLETION, TIME_SLICE}; //completion for FCFS, time slice for RR
-
-// Event class for managing simulation events.
-class Event{
-public:
-    int event_time; // time when the event occurs
-    EventType type; // type of event (arrival, completion, or time slice)
-    int process_id; // ID of the process associated with the event
-
-    Event(int time, EventType et, int pid) : event_time(time), type(et), process_id(pid){}
-
-    // comparator for priority queue to order events based on event time (good for FCFS since process order matters)
-    bool operator<(const Event& other) const{
-        return event_time > other.event_time;
+// compare load throughput of the iostream reader and the mmap reader on one file
+int benchmarkParse(const string& filename){
+    MappedFile file(filename);
+    if(!file.is_open()){
+        cout << "Error: cannot open " << filename << "\n";
+        return 1;
     }
-
-};
-
-// Process class representing a process in the simulation.
-class Process{
-public:
-    int p_id; //unique process IDs for incomming processes
-    int arrival_time, burst_time; // Arrival time and total CPU burst time of the process.
-    int start_time, end_time; // Start and end times of process execution.
-    int turnaround_time, waiting_time, response_time; // Performance metrics.
-    int remaining_time; // Remaining burst time for Round Robin scheduling. (no need in FCFS since processes will be started then finished undisturbed)
-
-    Process(int id, int arrival, int burst): 
-      p_id(id), arrival_time(arrival), burst_time(burst), start_time(0), end_time(0),
-      turnaround_time(0), waiting_time(0), response_time(0), remaining_time(burst) {}
-};
-
-// Sorting functions for processes.
-bool sortByArrivalTime(const Process& p1, const Process& p2){
-    return p1.arrival_time < p2.arrival_time;
-}
-
-bool sortByProcessID(const Process& p1, const Process& p2){
-    return p1.p_id < p2.p_id; 
+    double megabytes = file.size() / (1024.0 * 1024.0);
+
+    auto time_reader = [&](const char* name, Workload (*reader)(const string&, int)){
+        auto start = chrono::steady_clock::now();
+        Workload processes = reader(filename, -1);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << left << setw(10) << name << right << setw(12) << processes.size() << " processes  "
+             << fixed << setprecision(3) << setw(10) << seconds << " s  "
+             << setprecision(1) << setw(10) << megabytes / seconds << " MB/s\n";
+        cout.unsetf(ios::floatfield);
+    };
+
+    cout << "Parsing " << filename << " (" << fixed << setprecision(1) << megabytes << " MB)\n";
+    cout.unsetf(ios::floatfield);
+    if(isBinaryWorkload(file)){
+        time_reader("binary", readProcesses); // the iostream reader only understands text
+    }else{
+        time_reader("iostream", readProcessesStream);
+        time_reader("mmap", readProcesses);
+    }
+    return 0;
 }
 
-const int SWITCH_TIME = 2; //context switch time between processes, because naturally it takes time to save and load new process.
-
-// calculate data of the processes
-void calculateMetrics(vector<Process>& processes, float& avg_rt, float& avg_tat, float& avg_wt, float& cpu_efficiency, int total_execution_time, int total_switch_time){
-    int total_tat = 0, total_wt = 0, total_rt = 0;
-
-    for(auto& process : processes){
-      // calculate times
-      process.turnaround_time = process.end_time - process.arrival_time; //TAT = waiting time + service time, such as in this case the TAT is the processes's time of completion the moment it arrives in the ready queue unti it completes its burst time plus additional waiting times from stuff like context switching, convoy effect, etc.
-      process.waiting_time = process.turnaround_time - process.burst_time; //Waiting time = TAT- Service Time
-      process.response_time = process.start_time - process.arrival_time;
-
-      total_tat += process.turnaround_time;
-      total_wt += process.waiting_time;
-      total_rt += process.response_time;
-
+// "hold" benchmark: keep a population of pending events and repeatedly pop the earliest one and push a
+// follow-up a short random delay later, the way arrivals, completions and time slices behave in runSimulation
+template<class EventQueue>
+double holdBenchmark(long long operations, size_t population){
+    EventQueue event_queue;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    auto next_delay = [&rng]{
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; // xorshift64
+        return static_cast<int>(rng % 100) + 1;
+    };
+    for(size_t i = 0; i < population; ++i){
+        event_queue.push(Event(next_delay(), EventType::ARRIVAL, static_cast<int>(i)));
     }
 
-    // Calculating average metrics and CPU efficiency.
-    avg_tat = static_cast<float>(total_tat) / processes.size();
-    avg_wt = static_cast<float>(total_wt) / processes.size();
-    avg_rt = static_cast<float>(total_rt) / processes.size();
-    cpu_efficiency = (static_cast<float>(total_execution_time) / (total_execution_time + total_switch_time)) * 100.0f; //efficient cpu utilization would have low execution times and low context swiitch times
+    long long checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for(long long n = 0; n < operations; ++n){
+        Event event = event_queue.top();
+        event_queue.pop();
+        checksum += event.process;
+        event_queue.push(Event(event.event_time + next_delay(), EventType::TIME_SLICE, event.process));
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if(checksum == -1) cout << ""; // keep the loop from being optimized away
+    return seconds * 1e9 / operations;
 }
-//-------------------------------------------------------------------DISPLAY------------------------------------
-// display the calculated results
-void displayResults(const vector<Process>& processes, const float avg_rt, const float avg_tat, const float avg_wt, const float cpu_efficiency){
-    cout << "Total Time required is " << processes.back().end_time << " time units\n";
-    cout << "Average Turn Around Time: " << avg_tat << " time units\n";
-    cout << "Average Waiting Time: " << avg_wt << " time units\n";
-    cout << "Average Response Time: " << avg_rt << " time units\n";
-    cout << "CPU Efficiency: " << cpu_efficiency << "%\n\n";
 
-    // Displaying details for each process.
-    for(const auto& process : processes){
-      cout << "Process " << process.p_id << ":\n";
-      cout << "Service time = " << process.burst_time << " time units\n";
-      cout << "Turnaround time = " << process.turnaround_time << " time units\n";
-      cout << "Waiting time = " << process.waiting_time << " time units\n";
-      cout << "Response time = " << process.response_time << " time units\n\n";
+// compare the heap and calendar event queues at increasing event counts
+int benchmarkEventQueues(){
+    const size_t MAX_POPULATION = 1 << 20; // pending events stay bounded so 100M events fit in memory
+    cout << setw(12) << "events" << setw(12) << "pending" << setw(14) << "heap ns/op" << setw(18) << "calendar ns/op" << "\n";
+    for(long long events : {1000LL, 1000000LL, 100000000LL}){
+        size_t population = static_cast<size_t>(min<long long>(events, MAX_POPULATION));
+        double heap_ns = holdBenchmark<HeapEventQueue>(events, population);
+        double calendar_ns = holdBenchmark<CalendarEventQueue>(events, population);
+        cout << setw(12) << events << setw(12) << population << fixed << setprecision(1)
+             << setw(14) << heap_ns << setw(18) << calendar_ns << "\n";
+        cout.unsetf(ios::floatfield);
     }
+    return 0;
 }
 
-// Main function for running the CPU scheduling simulation.
-void runSimulation(vector<Process>& processes,int time_quantum,bool isRR){
-    priority_queue<Event> event_queue; // queue for process arrival order
-    queue<int> ready_queue; // ready queue for processes ready to run
-    map<int, Process*> process_map; // access process by ID On their map 
-    int current_time = 0; // simulation current time
-    Process* current_process = nullptr; // pointer to the currently waiting process in RQ
-    int total_execution_time = 0; // total execution time for CPU efficiency calculation
+// generate a synthetic workload and write it as text ("-" for stdout) or in the binary workload format
+int generateWorkloadFile(const GeneratorOptions& options, const string& output, bool binary){
+    ostream& info = output == "-" ? cerr : cout; // the workload itself may be going to stdout
+    Workload workload;
+    string error;
+    auto start = chrono::steady_clock::now();
+    if(!generateWorkload(options, workload, error)){
+        info << "Error: " << error << "\n";
+        return 1;
+    }
+    double generate_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-    // Initialize the event queue with the arrival of all processes.
-    for(auto& process:processes){
-        event_queue.push(Event(process.arrival_time, EventType::ARRIVAL, process.p_id));
-        process_map[process.p_id] = &process;
+    start = chrono::steady_clock::now();
+    if(binary ? !writeBinaryWorkload(workload, output) : !writeTextWorkload(workload, output)){
+        info << "Error: cannot write " << output << "\n";
+        return 1;
     }
+    double write_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if(output == "-") return 0;
+    double megabytes = MappedFile(output).size() / (1024.0 * 1024.0);
+    info << "Wrote " << workload.size() << " processes to " << output << fixed << setprecision(3) << " (generated in "
+         << generate_seconds << " s, " << setprecision(1) << megabytes << " MB written in " << setprecision(3)
+         << write_seconds << " s, " << setprecision(1) << megabytes / write_seconds << " MB/s)\n";
+    info.unsetf(ios::floatfield);
+    return 0;
+}
 
-    // Simulation loop processing each event in chronological order.
-    while(!event_queue.empty()){
-        Event event = event_queue.top();
-        event_queue.pop();
+// rebuild a workload from a perf sched / ftrace text dump and write it like generateWorkloadFile() does
+int importTraceFile(const string& trace, const string& output, const TraceImportOptions& options, bool binary){
+    ostream& info = output == "-" ? cerr : cout;
+    Workload workload;
+    TraceImportStats stats;
+    string error;
+    if(!importSchedTrace(trace, options, workload, stats, error)){
+        info << "Error: " << error << "\n";
+        return 1;
+    }
+    if(binary ? !writeBinaryWorkload(workload, output) : !writeTextWorkload(workload, output)){
+        info << "Error: cannot write " << output << "\n";
+        return 1;
+    }
 
-        current_time = event.event_time; // Updating current time to the time of the event.
+    double megabytes = stats.bytes / (1024.0 * 1024.0);
+    double seconds = max(stats.seconds, 1e-9);
+    info << "Imported " << stats.tasks << " tasks (" << stats.bursts << " CPU bursts) from " << stats.events
+         << " scheduler events in " << stats.lines << " lines of " << trace << "\n";
+    if(stats.reused_pids){
+        info << stats.reused_pids << " tasks reused the pid of one that had exited; each got id pid + n * "
+             << TRACE_PID_SPAN << " for the n earlier tasks with its pid\n";
+    }
+    info << fixed << setprecision(1) << megabytes << " MB in " << setprecision(3) << stats.seconds << " s: "
+         << setprecision(1) << megabytes / seconds << " MB/s, " << stats.events / seconds / 1e6 << " M events/s\n";
+    info.unsetf(ios::floatfield);
+    return 0;
+}
 
-        switch(event.type){
-            // Arrival event handling.
-            case EventType::ARRIVAL:{
-                auto& proc = process_map[event.process_id];
-                if (!current_process){
-                    current_process = proc;
-                    current_process->start_time = current_time;
-                    if(isRR){
-                        // Schedule a time slice event for Round Robin (REMEMBER RR IS BASED ON A TIME SLICE SO EVERY PROCESS GET ITS FAIR SHARE.)
-                        event_queue.push(Event(current_time + time_quantum, EventType::TIME_SLICE, proc->p_id));
-                    }else{
-                        // Schedule a completion event for FCFS (FCFS IS BASED ON COMPLETION OF PROCESSES IN ARRIVAL ORDER)
-                        event_queue.push(Event(current_time + proc->burst_time, EventType::COMPLETION, proc->p_id));
-                    }
-                }else{
-                    // If there is a current process, add this process to the ready queue.
-                  ready_queue.push(proc->p_id);
-                }
-                break;
+int main(int argc, char* argv[]){
+    int num_processes, choice, time_quantum;
+    Workload workload;
+
+    SimulationOptions options;
+    vector<int> sweep_quanta, sweep_switch_times;
+    GeneratorOptions generator;
+    string generate_output;
+    string import_trace, import_output;
+    TraceImportOptions trace_options;
+    bool write_binary = false; // --generate and --import-trace write the binary workload format
+    string serve_socket;
+    unsigned serve_workers = 0;
+    EnsembleOptions ensemble;
+    ensemble.replicas = 0; // no ensemble unless asked for
+    string what_if_prefix, what_if_branches, snapshot_in, snapshot_out;
+    long long what_if_time = 0;
+    string batch_runs;
+    int run_quantum = 4; // --quantum: RR's quantum for --ensemble, --what-if and --batch
+    unsigned run_threads = 0; // --threads: for the same three, 0 for one per core
+    SimulatorStats stats;
+    SimulatorStats* run_stats = nullptr; // --stats: instrument the interactive run
+
+    // command line options, the simulation itself is still driven by the prompts below
+    for(int i = 1; i < argc; ++i){
+        if(strcmp(argv[i], "--parse-bench") == 0 && i + 1 < argc){
+            return benchmarkParse(argv[i + 1]); // report load throughput instead of simulating
+        }else if(strcmp(argv[i], "--convert") == 0 && i + 2 < argc){
+            return convertWorkload(argv[i + 1], argv[i + 2]); // write a binary workload instead of simulating
+        }else if(strcmp(argv[i], "--queue-bench") == 0){
+            return benchmarkEventQueues(); // compare event queues instead of simulating
+        }else if(strcmp(argv[i], "--calendar-queue") == 0){
+            options.queue_kind = EventQueueKind::CALENDAR;
+        }else if(strcmp(argv[i], "--summary") == 0){
+            options.summary_only = true;
+        }else if(strcmp(argv[i], "--stats") == 0){
+            run_stats = &stats;
+        }else if(strcmp(argv[i], "--format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "human") == 0){
+            options.format = OutputFormat::HUMAN;
+            ++i;
+        }else if(strcmp(argv[i], "--format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "csv") == 0){
+            options.format = OutputFormat::CSV;
+            ++i;
+        }else if(strcmp(argv[i], "--format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "jsonl") == 0){
+            options.format = OutputFormat::JSONL;
+            ++i;
+        }else if(strcmp(argv[i], "--rr-fast-forward") == 0){
+            options.rr_fast_forward = true;
+        }else if(strcmp(argv[i], "--verify-rr") == 0){
+            options.verify_rr = true;
+        }else if(strcmp(argv[i], "--switch-cost") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 0){
+            options.switch_cost.fixed = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--cache-warmup") == 0 && i + 2 < argc && atoi(argv[i + 1]) >= 0 && atoi(argv[i + 2]) > 0){
+            options.switch_cost.warmup = atoi(argv[++i]);
+            options.switch_cost.warmup_time = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--warmup-curve") == 0 && i + 1 < argc && strcmp(argv[i + 1], "linear") == 0){
+            options.switch_cost.curve = WarmupCurve::LINEAR;
+            ++i;
+        }else if(strcmp(argv[i], "--warmup-curve") == 0 && i + 1 < argc && strcmp(argv[i + 1], "exp") == 0){
+            options.switch_cost.curve = WarmupCurve::EXPONENTIAL;
+            ++i;
+        }else if(strcmp(argv[i], "--cfs-latency") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            options.target_latency = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--cfs-min-granularity") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            options.min_granularity = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--mlfq-quanta") == 0 && i + 1 < argc){
+            vector<int> quanta;
+            if(!parseSweepValues(argv[++i], quanta) || quanta.size() > MLFQ_MAX_LEVELS ||
+               *min_element(quanta.begin(), quanta.end()) <= 0){
+                cout << "Error: MLFQ quanta must be 1 to " << MLFQ_MAX_LEVELS << " positive values like 4,8,16\n";
+                return 1;
             }
-
-          //---------------------------------------------------------------------------------
-            // Completion event handling for FCFS
-            case EventType::COMPLETION:{
-              //RETRIEve process that just finished execitopm
-                auto& proc = process_map[event.process_id];
-                proc->end_time =current_time; // mark the completion time of the process. //this is the gap start
-              // update the total execution time with the burst time (aka srrvcie time) of the completed process
-              // This represents the cumulative time the CPU has been active
-
-                total_execution_time+=proc->burst_time; // Add to total execution time
-                current_process =nullptr; // Current process is now complete. reset it to null we dont need it anymore
-
-                // Check if there's a next process in the ready queue.
-                if (!ready_queue.empty()) { // there are processes waiting to be executed
-                    int next_pid = ready_queue.front(); //arrival order matters in FCFS, get the one in front
-                    ready_queue.pop(); //pop the selected process from the RQ to start its exeuction.
-                    current_process = process_map[next_pid];
-                    current_process->start_time = current_time; //this is the gap end. the current processes start time is now the current time.
-                    // Schedule the next completion event for the new process.
-                    event_queue.push(Event(current_time + current_process->burst_time, EventType::COMPLETION, next_pid));
-                }
-                break;
+            options.mlfq_quanta = quanta;
+        }else if(strcmp(argv[i], "--mlfq-boost") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 0){
+            options.mlfq_boost_period = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--cores") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            options.cores = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--placement") == 0 && i + 1 < argc && strcmp(argv[i + 1], "rr") == 0){
+            options.placement = CorePlacement::ROUND_ROBIN;
+            ++i;
+        }else if(strcmp(argv[i], "--placement") == 0 && i + 1 < argc && strcmp(argv[i + 1], "shortest") == 0){
+            options.placement = CorePlacement::SHORTEST_QUEUE;
+            ++i;
+        }else if(strcmp(argv[i], "--steal") == 0 && i + 1 < argc && strcmp(argv[i + 1], "none") == 0){
+            options.steal = StealPolicy::NONE;
+            ++i;
+        }else if(strcmp(argv[i], "--steal") == 0 && i + 1 < argc && strcmp(argv[i + 1], "idle") == 0){
+            options.steal = StealPolicy::IDLE;
+            ++i;
+        }else if(strcmp(argv[i], "--generate") == 0 && i + 2 < argc && atoll(argv[i + 1]) > 0){
+            generator.count = atoll(argv[i + 1]);
+            generate_output = argv[i + 2];
+            i += 2;
+        }else if(strcmp(argv[i], "--arrivals") == 0 && i + 1 < argc && parseArrivalProcess(argv[i + 1], generator.arrivals)){
+            ++i;
+        }else if(strcmp(argv[i], "--bursts") == 0 && i + 1 < argc && parseBurstDistribution(argv[i + 1], generator.bursts)){
+            ++i;
+        }else if(strcmp(argv[i], "--mean-burst") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0){
+            generator.mean_burst = atof(argv[++i]);
+        }else if(strcmp(argv[i], "--load") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0){
+            generator.load = atof(argv[++i]);
+        }else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc){
+            generator.seed = strtoull(argv[++i], nullptr, 10);
+        }else if(strcmp(argv[i], "--binary") == 0){
+            write_binary = true;
+        }else if(strcmp(argv[i], "--import-trace") == 0 && i + 2 < argc){
+            import_trace = argv[i + 1];
+            import_output = argv[i + 2];
+            i += 2;
+        }else if(strcmp(argv[i], "--trace-unit") == 0 && i + 1 < argc && atoll(argv[i + 1]) > 0){
+            trace_options.time_unit_ns = atoll(argv[++i]);
+        }else if(strcmp(argv[i], "--trace-disk-queue") == 0){
+            trace_options.queue_disk_waits = true;
+        }else if(strcmp(argv[i], "--serve") == 0 && i + 1 < argc){
+#ifdef _WIN32
+            cout << "Error: the simulation daemon listens on a Unix domain socket, which is not supported on this platform\n";
+            return 1;
+#endif
+            serve_socket = argv[++i];
+        }else if(strcmp(argv[i], "--workers") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            serve_workers = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--ensemble") == 0 && i + 2 < argc && atoll(argv[i + 1]) > 0 && atoll(argv[i + 2]) > 0){
+            ensemble.replicas = atoll(argv[i + 1]);
+            ensemble.workload.count = atoll(argv[i + 2]);
+            i += 2;
+        }else if(strcmp(argv[i], "--quantum") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            run_quantum = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            run_threads = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "--timeline") == 0 && i + 1 < argc){
+#ifdef SCHEDULER_NO_TRACE
+            cout << "Error: this build records no timelines (configured with -DSCHEDULER_TRACE=OFF)\n";
+            return 1;
+#endif
+            options.timeline = argv[++i];
+        }else if(strcmp(argv[i], "--timeline-capacity") == 0 && i + 1 < argc && atoll(argv[i + 1]) > 0){
+            options.timeline_capacity = atoll(argv[++i]);
+        }else if(strcmp(argv[i], "--what-if") == 0 && i + 3 < argc && atoll(argv[i + 2]) >= 0){
+            what_if_prefix = argv[i + 1];
+            what_if_time = atoll(argv[i + 2]);
+            what_if_branches = argv[i + 3];
+            i += 3;
+        }else if(strcmp(argv[i], "--what-if-from") == 0 && i + 2 < argc){
+            snapshot_in = argv[i + 1];
+            what_if_branches = argv[i + 2];
+            i += 2;
+        }else if(strcmp(argv[i], "--snapshot-out") == 0 && i + 1 < argc){
+            snapshot_out = argv[++i];
+        }else if(strcmp(argv[i], "--batch") == 0 && i + 1 < argc){
+            batch_runs = argv[++i];
+        }else if(strcmp(argv[i], "--sweep") == 0 && i + 2 < argc){
+            if(!parseSweepValues(argv[i + 1], sweep_quanta) || !parseSweepValues(argv[i + 2], sweep_switch_times)){
+                cout << "Error: sweep values must look like 5,10,20 or 1:100:5\n";
+                return 1;
             }
+            i += 2;
+        }else{
+            cout << "Usage: " << argv[0] << " [--summary] [--format human|csv|jsonl] [--calendar-queue] [--rr-fast-forward] [--verify-rr] [--sweep <quanta> <switch times>]"
+                 << " [--switch-cost <t>] [--cache-warmup <penalty> <time>] [--warmup-curve linear|exp]"
+                 << " [--cfs-latency <t>] [--cfs-min-granularity <t>]"
+                 << " [--mlfq-quanta <q1,q2,...>] [--mlfq-boost <t>] [--cores <n>] [--placement rr|shortest] [--steal none|idle] [--parse-bench <file>] [--queue-bench]"
+                 << " [--convert <text workload> <binary workload>]"
+                 << " [--generate <n> <file|-> [--arrivals poisson|mmpp|diurnal] [--bursts exponential|pareto|bimodal]"
+                 << " [--mean-burst <t>] [--load <l>] [--seed <n>] [--binary]]"
+                 << " [--import-trace <trace|-> <file|-> [--trace-unit <ns>] [--trace-disk-queue] [--binary]]"
+                 << " [--serve <socket> [--workers <n>]]"
+                 << " [--ensemble <replicas> <processes> [--quantum <q>] [--threads <n>] [generator options]]"
+                 << " [--what-if <policy[:q]> <time> <branches> [--snapshot-out <file>]] [--what-if-from <snapshot> <branches>]"
+                 << " [--timeline <trace.json> [--timeline-capacity <records>]] [--stats]"
+                 << " [--batch <policy[:q],...|all> [--quantum <q>] [--threads <n>]]\n";
+            return 1;
+        }
+    }
 
-//---------------------------------------------------------------------------------------------------
-            // Time slice event handling for Round Robin.
-            case EventType::TIME_SLICE:{
-                if(current_process && current_process->p_id == event.process_id){
-                    current_process->remaining_time -= time_quantum; // Decrease remaining time of current processs by time quantum (its their turn to execute in the given amount of time)
-                    if(current_process->remaining_time <= 0){ //process COMPLETE! It finished in its TQ
-                    
-                        current_process->end_time = current_time; // mark completion time of the process
-                        total_execution_time += (current_process->burst_time - current_process->remaining_time); //update exeuction time, account for the total time it ran for ^
-                        current_process = nullptr; // reset current process since its already finished
-                    }else{
-                        // If process didnt finish in its TQ, enqueue it again back in the ready queue.
-                        ready_queue.push(current_process->p_id);
-                    }
+    // generate mode: write a synthetic workload instead of simulating
+    if(!generate_output.empty()){
+        return generateWorkloadFile(generator, generate_output, write_binary);
+    }
 
-                    // Scheduling processes from ready queue
-                    if(!ready_queue.empty()){ //more processes waiting for its time share
-                        int next_pid = ready_queue.front(); //pick the one in the front
-                        ready_queue.pop(); // pop the selected process and start its execution
-                        current_process = process_map[next_pid];
-                        current_process->start_time = current_time;
-                        // Schedule the next time slice event with time Quantum 
-                        int next_time_slice = min(time_quantum, current_process->remaining_time);
-                        event_queue.push(Event(current_time + next_time_slice, EventType::TIME_SLICE, next_pid));
-                    }
-                }
-                break;
-            }
-        }
+    // import mode: turn a scheduler trace into a workload file instead of simulating
+    if(!import_trace.empty()){
+        return importTraceFile(import_trace, import_output, trace_options, write_binary);
     }
 
-    //display simulation results
-    float avg_rt, avg_tat, avg_wt, cpu_efficiency;
-    calculateMetrics(processes, avg_rt, avg_tat, avg_wt, cpu_efficiency, total_execution_time, SWITCH_TIME * processes.size());
-    displayResults(processes, avg_rt, avg_tat, avg_wt, cpu_efficiency);
-}
+    // ensemble mode: simulate many generated replicas under every policy and report confidence intervals
+    if(ensemble.replicas > 0){
+        EnsembleResult result;
+        string error;
+        GeneratorOptions count = ensemble.workload; // the generator flags fill generator, the counts came with --ensemble
+        ensemble.workload = generator;
+        ensemble.workload.count = count.count;
+        ensemble.time_quantum = run_quantum;
+        ensemble.threads = run_threads;
+        if(!runEnsemble(ensemble, options, result, error)){
+            cout << "Error: " << error << "\n";
+            return 1;
+        }
+        displayEnsemble(ensemble, result);
+        return 0;
+    }
 
-// read input.txt
-vector<Process> readProcesses(const string& filename, int num_processes){
-    ifstream infile(filename); // Open input.txt
-    vector<Process> processes; // Vector to store processes.
-    int id, arrival, burst;
+    // what-if mode: simulate input.txt up to a time once (or load a snapshot of that), then carry on from there
+    // under every branch in parallel
+    if(!what_if_branches.empty()){
+        vector<WhatIfBranch> branches;
+        SchedulingPolicy prefix_policy;
+        int prefix_quantum;
+        string error;
+        if(!parseWhatIfBranches(what_if_branches, run_quantum, branches, error)){
+            cout << "Error: " << error << "\n";
+            return 1;
+        }
+        if(snapshot_in.empty() && !parsePolicySpec(what_if_prefix, run_quantum, prefix_policy, prefix_quantum)){
+            cout << "Error: the prefix policy looks like RR:4 or CFS, not \"" << what_if_prefix << "\"\n";
+            return 1;
+        }
+        workload = readProcesses("input.txt", -1);
+        if(workload.empty()){
+            cout << "Error: no processes read from input.txt\n";
+            return 1;
+        }
 
-    //read each process
-    for(int i = 0; i < num_processes; ++i){
-        if(infile >> id >> arrival >> burst){
-            processes.emplace_back(id, arrival, burst);
+        SimulationSnapshot snapshot;
+        auto start = chrono::steady_clock::now();
+        bool loaded = snapshot_in.empty() ? takeSnapshot(workload, prefix_policy, prefix_quantum, what_if_time, options, snapshot, error)
+                                          : readSnapshot(snapshot_in, snapshot, error);
+        if(!loaded){
+            cout << "Error: " << error << "\n";
+            return 1;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << (snapshot_in.empty() ? "Simulated " : "Loaded ") << policyName(snapshot.policy) << " up to t=" << snapshot.time
+             << ": " << snapshot.metrics.completed << " processes done, " << snapshot.events << " events, in "
+             << fixed << setprecision(3) << seconds << " s\n";
+        cout.unsetf(ios::floatfield);
+        if(!snapshot_out.empty() && !writeSnapshot(snapshot, snapshot_out)){
+            cout << "Error: can't write " << snapshot_out << "\n";
+            return 1;
         }
+        if(!runWhatIf(workload, snapshot, branches, options, run_threads, error)){
+            cout << "Error: " << error << "\n";
+            return 1;
+        }
+        return 0;
     }
 
-    return processes; //return list of process
-}
+    // daemon mode: answer simulation requests on a Unix socket until stopped, see server.h
+#ifndef _WIN32
+    if(!serve_socket.empty()){
+        return runServer(serve_socket, serve_workers, options);
+    }
+#endif
+
+    // batch mode: every run on the whole of input.txt, read once and simulated in parallel, no prompts
+    if(!batch_runs.empty()){
+        workload = readProcesses("input.txt", -1);
+        if(workload.empty()){
+            cout << "Error: no processes read from input.txt\n";
+            return 1;
+        }
+        vector<BatchRun> runs;
+        string error;
+        if(!parseBatchRuns(batch_runs, run_quantum, workload, options, runs, error) ||
+           !runBatch(workload, runs, options, run_threads, error)){
+            cout << "Error: " << error << "\n";
+            return 1;
+        }
+        return 0;
+    }
 
-int main(){
-    int num_processes, choice, time_quantum;
-    vector<Process> processes;
+    // sweep mode: RR over every (quantum, switch time) pair on the whole of input.txt, no prompts
+    if(!sweep_quanta.empty()){
+        workload = readProcesses("input.txt", -1);
+        if(workload.empty()){
+            cout << "Error: no processes read from input.txt\n";
+            return 1;
+        }
+        if(!workload.ioColumn().empty() && options.cores > 1){
+            cout << "Error: processes with I/O are only simulated on one CPU, without --cores\n";
+            return 1;
+        }
+        runSweep(workload, sweep_quanta, sweep_switch_times, options);
+        return 0;
+    }
 
     //user prompt
-    cout << "Choose the Scheduling Algorithm:\n";
-    cout << "1. First-Come, First-Served (FCFS)\n";
-    cout << "2. Round Robin (RR)\n";
-    cout << "Enter your choice (1 or 2): ";
+    ostream& prompt = infoStream(options); // keeps CSV/JSON output on stdout clean
+    prompt << "Choose the Scheduling Algorithm:\n";
+    prompt << "1. First-Come, First-Served (FCFS)\n";
+    prompt << "2. Round Robin (RR)\n";
+    prompt << "3. Completely Fair Scheduler (CFS)\n";
+    prompt << "4. Shortest Job First (SJF)\n";
+    prompt << "5. Shortest Remaining Time First (SRTF)\n";
+    prompt << "6. Multi-Level Feedback Queue (MLFQ)\n";
+    prompt << "Enter your choice (1-6): ";
     cin>>choice; 
 
     
-    cout<<"Enter number of processes: ";
+    prompt<<"Enter number of processes (-1 for all): ";
     cin>>num_processes; 
-    // Check if the number of processes exceeds the limit of 50.
-    if(num_processes>50){ //exit if limit exceeded
-        cout << "Error: Exceeds maximum process limit of 50.\n";
-        return 1; 
-    }
 
     // read processes from input file 
-    processes = readProcesses("input.txt", num_processes);
+    timePhase(run_stats, "readProcesses", [&]{ workload = readProcesses("input.txt", num_processes); });
+    if(workload.empty()){ //nothing to simulate
+        cout << "Error: no processes read from input.txt\n";
+        return 1;
+    }
+    ProcessTable processes(workload);
+    processes.stats = run_stats;
 
     // switch statements to execute algorithms
     switch(choice){
         case 1:
             // If choice is 1, run FCFS
-            runSimulation(processes, -1, false); // FCFS
+            if(!runSimulation(processes, -1, SchedulingPolicy::FCFS, options)) return 1;
             break;
         case 2:
             // If choice is 2, run RR
-            cout << "Enter the time quantum for RR: ";
+            prompt << "Enter the time quantum for RR: ";
             cin >> time_quantum; // TQ input
-            runSimulation(processes, time_quantum, true); 
+            if(!cin || time_quantum <= 0){ // a zero or negative quantum would never let RR make progress
+                cout << "Error: the time quantum must be a positive integer\n";
+                return 1;
+            }
+            if(!runSimulation(processes, time_quantum, SchedulingPolicy::RR, options)){
+                return 1; // --verify-rr found a mismatch
+            }
+            break;
+        case 3:
+            // CFS takes its latency and granularity from --cfs-latency / --cfs-min-granularity
+            if(!runSimulation(processes, -1, SchedulingPolicy::CFS, options)) return 1;
+            break;
+        case 4:
+            if(!runSimulation(processes, -1, SchedulingPolicy::SJF, options)) return 1;
+            break;
+        case 5:
+            if(!runSimulation(processes, -1, SchedulingPolicy::SRTF, options)) return 1;
+            break;
+        case 6:
+            // levels and boost period come from --mlfq-quanta / --mlfq-boost
+            if(!runSimulation(processes, -1, SchedulingPolicy::MLFQ, options)) return 1;
             break;
         default:
             // If an invalid choice is entered, show an error message.
@@ -256,629 +493,3 @@ int main(){
     }
     return 0; 
 }
-
-//
-// Choose the Scheduling Algorithm:
-// 1. First-Come, First-Served (FCFS)
-// 2. Round Robin (RR)
-// Enter your choice (1 or 2): 1
-// Enter number of processes: 50
-// Total Time required is 2321 time units
-// Average Turn Around Time: 1172.98 time units
-// Average Waiting Time: 1126.56 time units
-// Average Response Time: 1126.56 time units
-// CPU Efficiency: 95.8695%
-
-// Process 1:
-// Service time = 80 time units
-// Turnaround time = 80 time units
-// Waiting time = 0 time units
-// Response time = 0 time units
-
-// Process 2:
-// Service time = 17 time units
-// Turnaround time = 97 time units
-// Waiting time = 80 time units
-// Response time = 80 time units
-
-// Process 3:
-// Service time = 40 time units
-// Turnaround time = 136 time units
-// Waiting time = 96 time units
-// Response time = 96 time units
-
-// Process 4:
-// Service time = 29 time units
-// Turnaround time = 163 time units
-// Waiting time = 134 time units
-// Response time = 134 time units
-
-// Process 5:
-// Service time = 95 time units
-// Turnaround time = 327 time units
-// Waiting time = 232 time units
-// Response time = 232 time units
-
-// Process 6:
-// Service time = 48 time units
-// Turnaround time = 232 time units
-// Waiting time = 184 time units
-// Response time = 184 time units
-
-// Process 7:
-// Service time = 22 time units
-// Turnaround time = 184 time units
-// Waiting time = 162 time units
-// Response time = 162 time units
-
-// Process 8:
-// Service time = 24 time units
-// Turnaround time = 350 time units
-// Waiting time = 326 time units
-// Response time = 326 time units
-
-// Process 9:
-// Service time = 20 time units
-// Turnaround time = 369 time units
-// Waiting time = 349 time units
-// Response time = 349 time units
-
-// Process 10:
-// Service time = 60 time units
-// Turnaround time = 428 time units
-// Waiting time = 368 time units
-// Response time = 368 time units
-
-// Process 11:
-// Service time = 42 time units
-// Turnaround time = 492 time units
-// Waiting time = 450 time units
-// Response time = 450 time units
-
-// Process 12:
-// Service time = 23 time units
-// Turnaround time = 450 time units
-// Waiting time = 427 time units
-// Response time = 427 time units
-
-// Process 13:
-// Service time = 103 time units
-// Turnaround time = 594 time units
-// Waiting time = 491 time units
-// Response time = 491 time units
-
-// Process 14:
-// Service time = 23 time units
-// Turnaround time = 616 time units
-// Waiting time = 593 time units
-// Response time = 593 time units
-
-// Process 15:
-// Service time = 95 time units
-// Turnaround time = 705 time units
-// Waiting time = 610 time units
-// Response time = 610 time units
-
-// Process 16:
-// Service time = 105 time units
-// Turnaround time = 809 time units
-// Waiting time = 704 time units
-// Response time = 704 time units
-
-// Process 17:
-// Service time = 41 time units
-// Turnaround time = 848 time units
-// Waiting time = 807 time units
-// Response time = 807 time units
-
-// Process 18:
-// Service time = 35 time units
-// Turnaround time = 919 time units
-// Waiting time = 884 time units
-// Response time = 884 time units
-
-// Process 19:
-// Service time = 37 time units
-// Turnaround time = 884 time units
-// Waiting time = 847 time units
-// Response time = 847 time units
-
-// Process 20:
-// Service time = 5 time units
-// Turnaround time = 983 time units
-// Waiting time = 978 time units
-// Response time = 978 time units
-
-// Process 21:
-// Service time = 50 time units
-// Turnaround time = 978 time units
-// Waiting time = 928 time units
-// Response time = 928 time units
-
-// Process 22:
-// Service time = 12 time units
-// Turnaround time = 928 time units
-// Waiting time = 916 time units
-// Response time = 916 time units
-
-// Process 23:
-// Service time = 47 time units
-// Turnaround time = 1020 time units
-// Waiting time = 973 time units
-// Response time = 973 time units
-
-// Process 24:
-// Service time = 6 time units
-// Turnaround time = 1025 time units
-// Waiting time = 1019 time units
-// Response time = 1019 time units
-
-// Process 25:
-// Service time = 91 time units
-// Turnaround time = 1115 time units
-// Waiting time = 1024 time units
-// Response time = 1024 time units
-
-// Process 26:
-// Service time = 68 time units
-// Turnaround time = 1180 time units
-// Waiting time = 1112 time units
-// Response time = 1112 time units
-
-// Process 27:
-// Service time = 4 time units
-// Turnaround time = 1407 time units
-// Waiting time = 1403 time units
-// Response time = 1403 time units
-
-// Process 28:
-// Service time = 17 time units
-// Turnaround time = 1194 time units
-// Waiting time = 1177 time units
-// Response time = 1177 time units
-
-// Process 29:
-// Service time = 152 time units
-// Turnaround time = 1406 time units
-// Waiting time = 1254 time units
-// Response time = 1254 time units
-
-// Process 30:
-// Service time = 63 time units
-// Turnaround time = 1254 time units
-// Waiting time = 1191 time units
-// Response time = 1191 time units
-
-// Process 31:
-// Service time = 77 time units
-// Turnaround time = 1484 time units
-// Waiting time = 1407 time units
-// Response time = 1407 time units
-
-// Process 32:
-// Service time = 14 time units
-// Turnaround time = 1497 time units
-// Waiting time = 1483 time units
-// Response time = 1483 time units
-
-// Process 33:
-// Service time = 79 time units
-// Turnaround time = 1573 time units
-// Waiting time = 1494 time units
-// Response time = 1494 time units
-
-// Process 34:
-// Service time = 43 time units
-// Turnaround time = 1614 time units
-// Waiting time = 1571 time units
-// Response time = 1571 time units
-
-// Process 35:
-// Service time = 13 time units
-// Turnaround time = 1627 time units
-// Waiting time = 1614 time units
-// Response time = 1614 time units
-
-// Process 36:
-// Service time = 97 time units
-// Turnaround time = 1720 time units
-// Waiting time = 1623 time units
-// Response time = 1623 time units
-
-// Process 37:
-// Service time = 44 time units
-// Turnaround time = 1760 time units
-// Waiting time = 1716 time units
-// Response time = 1716 time units
-
-// Process 38:
-// Service time = 76 time units
-// Turnaround time = 1833 time units
-// Waiting time = 1757 time units
-// Response time = 1757 time units
-
-// Process 39:
-// Service time = 37 time units
-// Turnaround time = 1866 time units
-// Waiting time = 1829 time units
-// Response time = 1829 time units
-
-// Process 40:
-// Service time = 87 time units
-// Turnaround time = 1953 time units
-// Waiting time = 1866 time units
-// Response time = 1866 time units
-
-// Process 41:
-// Service time = 18 time units
-// Turnaround time = 1968 time units
-// Waiting time = 1950 time units
-// Response time = 1950 time units
-
-// Process 42:
-// Service time = 21 time units
-// Turnaround time = 1987 time units
-// Waiting time = 1966 time units
-// Response time = 1966 time units
-
-// Process 43:
-// Service time = 42 time units
-// Turnaround time = 2027 time units
-// Waiting time = 1985 time units
-// Response time = 1985 time units
-
-// Process 44:
-// Service time = 11 time units
-// Turnaround time = 2035 time units
-// Waiting time = 2024 time units
-// Response time = 2024 time units
-
-// Process 45:
-// Service time = 31 time units
-// Turnaround time = 2044 time units
-// Waiting time = 2013 time units
-// Response time = 2013 time units
-
-// Process 46:
-// Service time = 55 time units
-// Turnaround time = 2092 time units
-// Waiting time = 2037 time units
-// Response time = 2037 time units
-
-// Process 47:
-// Service time = 41 time units
-// Turnaround time = 2124 time units
-// Waiting time = 2083 time units
-// Response time = 2083 time units
-
-// Process 48:
-// Service time = 18 time units
-// Turnaround time = 2141 time units
-// Waiting time = 2123 time units
-// Response time = 2123 time units
-
-// Process 49:
-// Service time = 26 time units
-// Turnaround time = 2068 time units
-// Waiting time = 2042 time units
-// Response time = 2042 time units
-
-// Process 50:
-// Service time = 37 time units
-// Turnaround time = 2063 time units
-// Waiting time = 2026 time units
-// Response time = 2026 time units
-
-// Choose the Scheduling Algorithm:
-// 1. First-Come, First-Served (FCFS)
-// 2. Round Robin (RR)
-// Enter your choice (1 or 2): 2
-// Enter number of processes: 50
-// Enter the time quantum for RR: 2
-// Total Time required is 1613 time units
-// Average Turn Around Time: 1386.6 time units
-// Average Waiting Time: 1340.18 time units
-// Average Response Time: 1385.18 time units
-// CPU Efficiency: 95.9184%
-
-// Process 1:
-// Service time = 80 time units
-// Turnaround time = 2066 time units
-// Waiting time = 1986 time units
-// Response time = 2064 time units
-
-// Process 2:
-// Service time = 17 time units
-// Turnaround time = 570 time units
-// Waiting time = 553 time units
-// Response time = 569 time units
-
-// Process 3:
-// Service time = 40 time units
-// Turnaround time = 1388 time units
-// Waiting time = 1348 time units
-// Response time = 1386 time units
-
-// Process 4:
-// Service time = 29 time units
-// Turnaround time = 1100 time units
-// Waiting time = 1071 time units
-// Response time = 1099 time units
-
-// Process 5:
-// Service time = 95 time units
-// Turnaround time = 2229 time units
-// Waiting time = 2134 time units
-// Response time = 2228 time units
-
-// Process 6:
-// Service time = 48 time units
-// Turnaround time = 1619 time units
-// Waiting time = 1571 time units
-// Response time = 1617 time units
-
-// Process 7:
-// Service time = 22 time units
-// Turnaround time = 814 time units
-// Waiting time = 792 time units
-// Response time = 812 time units
-
-// Process 8:
-// Service time = 24 time units
-// Turnaround time = 930 time units
-// Waiting time = 906 time units
-// Response time = 928 time units
-
-// Process 9:
-// Service time = 20 time units
-// Turnaround time = 780 time units
-// Waiting time = 760 time units
-// Response time = 778 time units
-
-// Process 10:
-// Service time = 60 time units
-// Turnaround time = 1845 time units
-// Waiting time = 1785 time units
-// Response time = 1843 time units
-
-// Process 11:
-// Service time = 42 time units
-// Turnaround time = 1503 time units
-// Waiting time = 1461 time units
-// Response time = 1501 time units
-
-// Process 12:
-// Service time = 23 time units
-// Turnaround time = 942 time units
-// Waiting time = 919 time units
-// Response time = 941 time units
-
-// Process 13:
-// Service time = 103 time units
-// Turnaround time = 2257 time units
-// Waiting time = 2154 time units
-// Response time = 2256 time units
-
-// Process 14:
-// Service time = 23 time units
-// Turnaround time = 957 time units
-// Waiting time = 934 time units
-// Response time = 956 time units
-
-// Process 15:
-// Service time = 95 time units
-// Turnaround time = 2224 time units
-// Waiting time = 2129 time units
-// Response time = 2223 time units
-
-// Process 16:
-// Service time = 105 time units
-// Turnaround time = 2256 time units
-// Waiting time = 2151 time units
-// Response time = 2255 time units
-
-// Process 17:
-// Service time = 41 time units
-// Turnaround time = 1527 time units
-// Waiting time = 1486 time units
-// Response time = 1526 time units
-
-// Process 18:
-// Service time = 35 time units
-// Turnaround time = 1365 time units
-// Waiting time = 1330 time units
-// Response time = 1364 time units
-
-// Process 19:
-// Service time = 37 time units
-// Turnaround time = 1422 time units
-// Waiting time = 1385 time units
-// Response time = 1421 time units
-
-// Process 20:
-// Service time = 5 time units
-// Turnaround time = 212 time units
-// Waiting time = 207 time units
-// Response time = 211 time units
-
-// Process 21:
-// Service time = 50 time units
-// Turnaround time = 1697 time units
-// Waiting time = 1647 time units
-// Response time = 1695 time units
-
-// Process 22:
-// Service time = 12 time units
-// Turnaround time = 492 time units
-// Waiting time = 480 time units
-// Response time = 490 time units
-
-// Process 23:
-// Service time = 47 time units
-// Turnaround time = 1659 time units
-// Waiting time = 1612 time units
-// Response time = 1658 time units
-
-// Process 24:
-// Service time = 6 time units
-// Turnaround time = 229 time units
-// Waiting time = 223 time units
-// Response time = 227 time units
-
-// Process 25:
-// Service time = 91 time units
-// Turnaround time = 2191 time units
-// Waiting time = 2100 time units
-// Response time = 2190 time units
-
-// Process 26:
-// Service time = 68 time units
-// Turnaround time = 1960 time units
-// Waiting time = 1892 time units
-// Response time = 1958 time units
-
-// Process 27:
-// Service time = 4 time units
-// Turnaround time = 149 time units
-// Waiting time = 145 time units
-// Response time = 147 time units
-
-// Process 28:
-// Service time = 17 time units
-// Turnaround time = 778 time units
-// Waiting time = 761 time units
-// Response time = 777 time units
-
-// Process 29:
-// Service time = 152 time units
-// Turnaround time = 2277 time units
-// Waiting time = 2125 time units
-// Response time = 2275 time units
-
-// Process 30:
-// Service time = 63 time units
-// Turnaround time = 1904 time units
-// Waiting time = 1841 time units
-// Response time = 1903 time units
-
-// Process 31:
-// Service time = 77 time units
-// Turnaround time = 2072 time units
-// Waiting time = 1995 time units
-// Response time = 2071 time units
-
-// Process 32:
-// Service time = 14 time units
-// Turnaround time = 619 time units
-// Waiting time = 605 time units
-// Response time = 617 time units
-
-// Process 33:
-// Service time = 79 time units
-// Turnaround time = 2091 time units
-// Waiting time = 2012 time units
-// Response time = 2090 time units
-
-// Process 34:
-// Service time = 43 time units
-// Turnaround time = 1588 time units
-// Waiting time = 1545 time units
-// Response time = 1587 time units
-
-// Process 35:
-// Service time = 13 time units
-// Turnaround time = 627 time units
-// Waiting time = 614 time units
-// Response time = 626 time units
-
-// Process 36:
-// Service time = 97 time units
-// Turnaround time = 2202 time units
-// Waiting time = 2105 time units
-// Response time = 2201 time units
-
-// Process 37:
-// Service time = 44 time units
-// Turnaround time = 1584 time units
-// Waiting time = 1540 time units
-// Response time = 1582 time units
-
-// Process 38:
-// Service time = 76 time units
-// Turnaround time = 2044 time units
-// Waiting time = 1968 time units
-// Response time = 2042 time units
-
-// Process 39:
-// Service time = 37 time units
-// Turnaround time = 1437 time units
-// Waiting time = 1400 time units
-// Response time = 1436 time units
-
-// Process 40:
-// Service time = 87 time units
-// Turnaround time = 2141 time units
-// Waiting time = 2054 time units
-// Response time = 2140 time units
-
-// Process 41:
-// Service time = 18 time units
-// Turnaround time = 802 time units
-// Waiting time = 784 time units
-// Response time = 800 time units
-
-// Process 42:
-// Service time = 21 time units
-// Turnaround time = 947 time units
-// Waiting time = 926 time units
-// Response time = 946 time units
-
-// Process 43:
-// Service time = 42 time units
-// Turnaround time = 1535 time units
-// Waiting time = 1493 time units
-// Response time = 1533 time units
-
-// Process 44:
-// Service time = 11 time units
-// Turnaround time = 555 time units
-// Waiting time = 544 time units
-// Response time = 554 time units
-
-// Process 45:
-// Service time = 31 time units
-// Turnaround time = 1262 time units
-// Waiting time = 1231 time units
-// Response time = 1261 time units
-
-// Process 46:
-// Service time = 55 time units
-// Turnaround time = 1760 time units
-// Waiting time = 1705 time units
-// Response time = 1759 time units
-
-// Process 47:
-// Service time = 41 time units
-// Turnaround time = 1522 time units
-// Waiting time = 1481 time units
-// Response time = 1521 time units
-
-// Process 48:
-// Service time = 18 time units
-// Turnaround time = 804 time units
-// Waiting time = 786 time units
-// Response time = 802 time units
-
-// Process 49:
-// Service time = 26 time units
-// Turnaround time = 1041 time units
-// Waiting time = 1015 time units
-// Response time = 1039 time units
-
-// Process 50:
-// Service time = 37 time units
-// Turnaround time = 1355 time units
-// Waiting time = 1318 time units
-// Response time = 1354 time units
-
-
@@ -0,0 +1,239 @@
+// Node addon: the scheduling engine in-process for the web UI (cpu-scheduler/lib/native.ts).
+//
+//   simulate({ policy, quantum, arrivals, bursts, ids?, nice?, summaryOnly?, switchCost? }) -> Promise<result>
+//
+// policy is a SchedulingPolicy name ("FCFS", "RR", "SJF", "SRTF", "CFS", "MLFQ"). arrivals, bursts and the
+// optional ids (default 1..n) and nice values are Int32Arrays the engine reads in place, so nothing is copied and
+// they must not be written to until the promise settles. The simulation runs on libuv's thread pool, off the
+// event loop. The result has the same fields as a simulator daemon response (server.h): totalTime, the averages,
+// cpuEfficiency, and the startTime, endTime, turnaroundTime, waitingTime and responseTime columns as Int32Arrays
+// over the engine's own vectors (empty with summaryOnly).
+#include "scheduler.h"
+
+#include <node_api.h>
+
+#include <numeric>
+
+using namespace std;
+
+namespace{
+
+struct SimulateJob{
+    // set on the JS thread, read by the worker
+    SchedulingPolicy policy = SchedulingPolicy::FCFS;
+    int time_quantum = 0;
+    bool summary_only = false;
+    SimulationOptions options;
+    Workload workload;
+    vector<int> default_ids;
+    vector<napi_ref> inputs; // the arrays the workload points into, held until the job completes
+
+    // set by the worker
+    string error;
+    long long total_time = 0;
+    double avg_tat = 0, avg_wt = 0, avg_rt = 0, cpu_efficiency = 0;
+    vector<int> start_time, end_time, turnaround_time, waiting_time, response_time;
+
+    napi_async_work work = nullptr;
+    napi_deferred deferred = nullptr;
+};
+
+// options[name] when the caller set it
+bool property(napi_env env, napi_value options, const char* name, napi_value& value){
+    bool has = false;
+    napi_valuetype type = napi_undefined;
+    if(napi_has_named_property(env, options, name, &has) != napi_ok || !has) return false;
+    napi_get_named_property(env, options, name, &value);
+    napi_typeof(env, value, &type);
+    return type != napi_undefined && type != napi_null;
+}
+
+// options[name] as an Int32Array held by job: false, with a TypeError thrown, when it is something else or a
+// required one is missing; data stays null for a missing optional one
+bool int32Input(napi_env env, napi_value options, const char* name, bool required, SimulateJob& job,
+                const int*& data, size_t& length){
+    data = nullptr;
+    length = 0;
+    napi_value value;
+    if(!property(env, options, name, value)){
+        if(required) napi_throw_type_error(env, nullptr, (string(name) + " is required").c_str());
+        return !required;
+    }
+    bool is_typed_array = false;
+    napi_typedarray_type type;
+    void* bytes = nullptr;
+    napi_is_typedarray(env, value, &is_typed_array);
+    if(!is_typed_array || napi_get_typedarray_info(env, value, &type, &length, &bytes, nullptr, nullptr) != napi_ok ||
+       type != napi_int32_array){
+        napi_throw_type_error(env, nullptr, (string(name) + " must be an Int32Array").c_str());
+        return false;
+    }
+    napi_ref ref;
+    napi_create_reference(env, value, 1, &ref);
+    job.inputs.push_back(ref);
+    data = static_cast<const int*>(bytes);
+    return true;
+}
+
+bool intOption(napi_env env, napi_value options, const char* name, int& out){
+    napi_value value;
+    if(!property(env, options, name, value)) return true;
+    if(napi_get_value_int32(env, value, &out) != napi_ok){
+        napi_throw_type_error(env, nullptr, (string(name) + " must be a number").c_str());
+        return false;
+    }
+    return true;
+}
+
+// the worker thread: the same checks and run as a daemon request (see runRequest in server.cpp)
+void executeSimulate(napi_env, void* data){
+    SimulateJob& job = *static_cast<SimulateJob*>(data);
+    ProcessTable processes(job.workload);
+    job.error = invalidRun(processes, job.policy, job.time_quantum, job.options);
+    if(!job.error.empty()) return;
+
+    StreamingMetrics metrics;
+    processes.metrics = &metrics;
+    processes.keep_records = !job.summary_only;
+    long long total_execution_time = simulateProcesses(processes, job.time_quantum, job.policy, job.options);
+    job.total_time = metrics.makespan;
+    job.avg_tat = metrics.mean(metrics.total_tat);
+    job.avg_wt = metrics.mean(metrics.total_wt);
+    job.avg_rt = metrics.mean(metrics.total_rt);
+    job.cpu_efficiency = 100.0 * total_execution_time / max(1LL, total_execution_time + processes.switch_time);
+    if(!processes.keep_records) return;
+    float tat, wt, rt, efficiency; // fills the turnaround, waiting and response columns
+    calculateMetrics(processes, rt, tat, wt, efficiency, total_execution_time, processes.switch_time);
+    job.start_time = move(processes.start_time);
+    job.end_time = move(processes.end_time);
+    job.turnaround_time = move(processes.turnaround_time);
+    job.waiting_time = move(processes.waiting_time);
+    job.response_time = move(processes.response_time);
+}
+
+// an Int32Array that takes over column's storage
+napi_value int32Column(napi_env env, vector<int>& column){
+    auto* owned = new vector<int>(move(column));
+    size_t bytes = owned->size() * sizeof(int32_t);
+    napi_value buffer, array;
+    auto release = [](napi_env, void*, void* hint){ delete static_cast<vector<int>*>(hint); };
+    if(bytes == 0 || napi_create_external_arraybuffer(env, owned->data(), bytes, release, owned, &buffer) != napi_ok){
+        // empty, or a runtime that doesn't allow external buffers: copy after all
+        void* copy;
+        napi_create_arraybuffer(env, bytes, &copy, &buffer);
+        if(bytes) memcpy(copy, owned->data(), bytes);
+        delete owned;
+    }
+    napi_create_typedarray(env, napi_int32_array, bytes / sizeof(int32_t), buffer, 0, &array);
+    return array;
+}
+
+void setNumber(napi_env env, napi_value object, const char* name, double value){
+    napi_value number;
+    napi_create_double(env, value, &number);
+    napi_set_named_property(env, object, name, number);
+}
+
+// back on the JS thread: let go of the inputs and settle the promise
+void completeSimulate(napi_env env, napi_status status, void* data){
+    unique_ptr<SimulateJob> job(static_cast<SimulateJob*>(data));
+    for(napi_ref ref : job->inputs) napi_delete_reference(env, ref);
+    napi_delete_async_work(env, job->work);
+
+    if(status != napi_ok || !job->error.empty()){
+        napi_value message, error;
+        string text = status == napi_ok ? job->error : "simulation cancelled";
+        napi_create_string_utf8(env, text.c_str(), text.size(), &message);
+        napi_create_error(env, nullptr, message, &error);
+        napi_reject_deferred(env, job->deferred, error);
+        return;
+    }
+    napi_value result;
+    napi_create_object(env, &result);
+    setNumber(env, result, "totalTime", static_cast<double>(job->total_time));
+    setNumber(env, result, "avgTurnaroundTime", job->avg_tat);
+    setNumber(env, result, "avgWaitingTime", job->avg_wt);
+    setNumber(env, result, "avgResponseTime", job->avg_rt);
+    setNumber(env, result, "cpuEfficiency", job->cpu_efficiency);
+    napi_set_named_property(env, result, "startTime", int32Column(env, job->start_time));
+    napi_set_named_property(env, result, "endTime", int32Column(env, job->end_time));
+    napi_set_named_property(env, result, "turnaroundTime", int32Column(env, job->turnaround_time));
+    napi_set_named_property(env, result, "waitingTime", int32Column(env, job->waiting_time));
+    napi_set_named_property(env, result, "responseTime", int32Column(env, job->response_time));
+    napi_resolve_deferred(env, job->deferred, result);
+}
+
+// simulate(options): read the options, queue the job and hand back its promise
+napi_value simulate(napi_env env, napi_callback_info info){
+    size_t argc = 1;
+    napi_value options;
+    napi_valuetype type = napi_undefined;
+    napi_get_cb_info(env, info, &argc, &options, nullptr, nullptr);
+    if(argc > 0) napi_typeof(env, options, &type);
+    if(type != napi_object){
+        napi_throw_type_error(env, nullptr, "simulate takes an options object");
+        return nullptr;
+    }
+
+    auto job = make_unique<SimulateJob>();
+    // any return before the job is queued drops it, so its references are released here
+    auto abandon = [env](SimulateJob& failed){
+        for(napi_ref ref : failed.inputs) napi_delete_reference(env, ref);
+        return nullptr;
+    };
+
+    napi_value value;
+    char name[8] = "";
+    if(property(env, options, "policy", value)) napi_get_value_string_utf8(env, value, name, sizeof(name), nullptr);
+    const char* const* found = find_if(begin(POLICY_NAMES), end(POLICY_NAMES), [&](const char* policy){ return strcmp(policy, name) == 0; });
+    if(found == end(POLICY_NAMES)){
+        napi_throw_type_error(env, nullptr, "policy must be one of FCFS, RR, SJF, SRTF, CFS, MLFQ");
+        return nullptr;
+    }
+    job->policy = static_cast<SchedulingPolicy>(found - begin(POLICY_NAMES));
+    if(!intOption(env, options, "quantum", job->time_quantum) ||
+       !intOption(env, options, "switchCost", job->options.switch_cost.fixed)) return abandon(*job);
+    if(job->options.switch_cost.fixed < 0){
+        napi_throw_range_error(env, nullptr, "switchCost must be >= 0");
+        return abandon(*job);
+    }
+    if(property(env, options, "summaryOnly", value)) napi_get_value_bool(env, value, &job->summary_only);
+
+    const int *arrivals, *bursts, *ids, *nices;
+    size_t count, burst_count, id_count, nice_count;
+    if(!int32Input(env, options, "arrivals", true, *job, arrivals, count) ||
+       !int32Input(env, options, "bursts", true, *job, bursts, burst_count) ||
+       !int32Input(env, options, "ids", false, *job, ids, id_count) ||
+       !int32Input(env, options, "nice", false, *job, nices, nice_count)) return abandon(*job);
+    if(burst_count != count || (ids && id_count != count) || (nices && nice_count != count)){
+        napi_throw_range_error(env, nullptr, "arrivals, bursts, ids and nice must have the same length");
+        return abandon(*job);
+    }
+    if(!ids){
+        job->default_ids.resize(count);
+        iota(job->default_ids.begin(), job->default_ids.end(), 1);
+        ids = job->default_ids.data();
+    }
+    // the arrays outlive the workload through job->inputs, so the workload's owner only has to be non-null
+    shared_ptr<const void> inputs(job.get(), [](const void*){});
+    job->workload = Workload::mapped(inputs, ids, arrivals, bursts, nices, nullptr, nullptr, count);
+
+    napi_value promise, resource_name;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_create_string_utf8(env, "scheduler.simulate", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, nullptr, resource_name, executeSimulate, completeSimulate, job.get(), &job->work);
+    napi_queue_async_work(env, job->work);
+    job.release(); // completeSimulate owns it now
+    return promise;
+}
+
+napi_value init(napi_env env, napi_value exports){
+    napi_value function;
+    napi_create_function(env, "simulate", NAPI_AUTO_LENGTH, simulate, nullptr, &function);
+    napi_set_named_property(env, exports, "simulate", function);
+    return exports;
+}
+
+} // namespace
+
+NAPI_MODULE(scheduler_node, init)
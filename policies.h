@@ -0,0 +1,516 @@
+// Scheduling policies for simulatePolicy(). A policy owns the ready set and makes every scheduling decision
+// through eight hooks, which the engine calls directly so the compiler inlines them into the event loop:
+//
+//   void on_arrival(int proc, int now)        proc has arrived and is ready to run
+//   int  on_dispatch(int now, int& slice)     the CPU is free: take the next ready process off the ready set and
+//                                             set how long it runs before the timer fires (at most its remaining
+//                                             time); NO_PROCESS when nothing is ready
+//   void on_run(int proc, int start)          the process on_dispatch just picked starts running at start, once
+//                                             the context switch onto it is paid (start == now without one)
+//   void on_tick(int proc, int ran, int now)  proc came off the CPU after running for ran time units (the timer
+//                                             fired or it was preempted) and still has work left; it is ready again
+//   void on_complete(int proc, int ran, int now)
+//                                             proc finished after a last slice of ran time units
+//   void on_block(int proc, int ran, int now) proc ran out its CPU burst after a last slice of ran time units and
+//                                             went off to I/O; it is not ready until on_wakeup
+//   void on_wakeup(int proc, int now)         proc is back from I/O, ready with remaining_time set to its next burst
+//   bool should_preempt(int running, int remaining, int now)
+//                                             a process just arrived or woke up while running has remaining time
+//                                             units left in its slice's work; true takes it off the CPU right away
+//
+// Policies are constructed from (const ProcessTable&, int time_quantum, const SimulationOptions&). Processes are
+// dense indices into that ProcessTable; remaining_time is up to date whenever a hook runs.
+//
+// For snapshots (SimulationSnapshot in scheduler.h) a policy also saves and restores what it keeps between events:
+//
+//   void save(PolicyState& state) const       the ready set in the order it would dispatch it, plus whatever else
+//                                             the policy carries in state.per_process and state.counters
+//   bool restore(const PolicyState& state)    pick up from a saved state, on a freshly constructed policy whose
+//                                             table may have processes added at the end; false when the state
+//                                             doesn't fit this policy
+#ifndef POLICIES_H
+#define POLICIES_H
+
+#include "scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <vector>
+
+// a FIFO ready queue as a saved ready list, and back
+inline void saveQueue(std::queue<int> waiting, PolicyState& state){
+    for(; !waiting.empty(); waiting.pop()) state.ready.push_back(waiting.front());
+}
+
+inline bool restoreQueue(const PolicyState& state, std::queue<int>& ready_queue){
+    if(!state.per_process.empty() || !state.counters.empty()) return false;
+    for(int proc : state.ready) ready_queue.push(proc);
+    return true;
+}
+
+// First-Come, First-Served: run each process to completion in arrival order.
+class FcfsPolicy{
+public:
+    FcfsPolicy(const ProcessTable& processes, int /*time_quantum*/, const SimulationOptions& /*options*/): processes(processes) {}
+
+    void on_arrival(int proc, int /*now*/){ ready_queue.push(proc); }
+
+    int on_dispatch(int /*now*/, int& slice){
+        if(ready_queue.empty()) return NO_PROCESS;
+        int proc = ready_queue.front();
+        ready_queue.pop();
+        slice = processes.remaining_time[proc];
+        return proc;
+    }
+
+    void on_run(int /*proc*/, int /*start*/){}
+
+    void on_tick(int proc, int /*ran*/, int /*now*/){ ready_queue.push(proc); } // never fires, slices are whole bursts
+
+    void on_complete(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_block(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_wakeup(int proc, int /*now*/){ ready_queue.push(proc); }
+
+    bool should_preempt(int /*running*/, int /*remaining*/, int /*now*/) const{ return false; }
+
+    void save(PolicyState& state) const{ saveQueue(ready_queue, state); }
+
+    bool restore(const PolicyState& state){ return restoreQueue(state, ready_queue); }
+
+private:
+    const ProcessTable& processes;
+    std::queue<int> ready_queue;
+};
+
+// Round Robin: one quantum at a time in ready-queue order; a preempted process goes to the back, behind
+// anything that arrived while it ran.
+class RoundRobinPolicy{
+public:
+    RoundRobinPolicy(const ProcessTable& processes, int time_quantum, const SimulationOptions& /*options*/):
+      processes(processes), time_quantum(time_quantum) {}
+
+    void on_arrival(int proc, int /*now*/){ ready_queue.push(proc); }
+
+    int on_dispatch(int /*now*/, int& slice){
+        if(ready_queue.empty()) return NO_PROCESS;
+        int proc = ready_queue.front();
+        ready_queue.pop();
+        slice = std::min(time_quantum, processes.remaining_time[proc]);
+        return proc;
+    }
+
+    void on_run(int /*proc*/, int /*start*/){}
+
+    void on_tick(int proc, int /*ran*/, int /*now*/){ ready_queue.push(proc); }
+
+    void on_complete(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_block(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_wakeup(int proc, int /*now*/){ ready_queue.push(proc); }
+
+    bool should_preempt(int /*running*/, int /*remaining*/, int /*now*/) const{ return false; } // only the timer preempts
+
+    void save(PolicyState& state) const{ saveQueue(ready_queue, state); }
+
+    bool restore(const PolicyState& state){ return restoreQueue(state, ready_queue); }
+
+private:
+    const ProcessTable& processes;
+    int time_quantum;
+    std::queue<int> ready_queue;
+};
+
+// Ready-set key for the priority policies: smallest rank first, and processes with equal ranks in the order they
+// became ready, so ties go the way FCFS would break them.
+struct ReadyKey{
+    long long rank;
+    uint64_t seq;
+
+    bool operator<(const ReadyKey& other) const{ return rank != other.rank ? rank < other.rank : seq < other.seq; }
+};
+
+// Shortest Job First: whenever the CPU frees up, run the ready process with the shortest (next CPU) burst to
+// completion.
+class SjfPolicy{
+public:
+    SjfPolicy(const ProcessTable& processes, int /*time_quantum*/, const SimulationOptions& /*options*/): processes(processes){ ready.reserveItems(processes.size()); }
+
+    void on_arrival(int proc, int /*now*/){ ready.push(proc, ReadyKey{processes.remaining_time[proc], next_seq++}); }
+
+    int on_dispatch(int /*now*/, int& slice){
+        if(ready.empty()) return NO_PROCESS;
+        int proc = ready.pop();
+        slice = processes.remaining_time[proc];
+        return proc;
+    }
+
+    void on_run(int /*proc*/, int /*start*/){}
+
+    void on_tick(int proc, int /*ran*/, int now){ on_arrival(proc, now); } // never fires, slices are whole bursts
+
+    void on_complete(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_block(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_wakeup(int proc, int now){ on_arrival(proc, now); } // keyed by the next burst
+
+    bool should_preempt(int /*running*/, int /*remaining*/, int /*now*/) const{ return false; }
+
+    void save(PolicyState& state) const{ state.ready = ready.itemsInOrder(); }
+
+    // the keys come back from remaining_time, and pushing in order keeps the ties in order
+    bool restore(const PolicyState& state){
+        if(!state.per_process.empty() || !state.counters.empty()) return false;
+        for(int proc : state.ready) on_arrival(proc, 0);
+        return true;
+    }
+
+private:
+    const ProcessTable& processes;
+    IndexedDaryHeap<ReadyKey> ready; // keyed by remaining time
+    uint64_t next_seq = 0;
+};
+
+// Shortest Remaining Time First: SJF, except that an arrival with strictly less work than the running process has
+// left takes the CPU from it. The preempted process goes back into the ready set keyed by what it has left.
+class SrtfPolicy{
+public:
+    SrtfPolicy(const ProcessTable& processes, int /*time_quantum*/, const SimulationOptions& /*options*/): processes(processes){ ready.reserveItems(processes.size()); }
+
+    void on_arrival(int proc, int /*now*/){ ready.push(proc, ReadyKey{processes.remaining_time[proc], next_seq++}); }
+
+    int on_dispatch(int /*now*/, int& slice){
+        if(ready.empty()) return NO_PROCESS;
+        int proc = ready.pop();
+        slice = processes.remaining_time[proc]; // runs to completion unless something shorter arrives
+        return proc;
+    }
+
+    void on_run(int /*proc*/, int /*start*/){}
+
+    void on_tick(int proc, int /*ran*/, int now){ on_arrival(proc, now); }
+
+    void on_complete(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_block(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_wakeup(int proc, int now){ on_arrival(proc, now); } // keyed by the next burst
+
+    bool should_preempt(int /*running*/, int remaining, int /*now*/) const{
+        return !ready.empty() && ready.topKey().rank < remaining;
+    }
+
+    void save(PolicyState& state) const{ state.ready = ready.itemsInOrder(); }
+
+    // the keys come back from remaining_time, and pushing in order keeps the ties in order
+    bool restore(const PolicyState& state){
+        if(!state.per_process.empty() || !state.counters.empty()) return false;
+        for(int proc : state.ready) on_arrival(proc, 0);
+        return true;
+    }
+
+private:
+    const ProcessTable& processes;
+    IndexedDaryHeap<ReadyKey> ready; // keyed by remaining time
+    uint64_t next_seq = 0;
+};
+
+// Load weight of each nice value from -20 to 19, as in Linux: every step is about 10% more or less CPU, and nice 0
+// weighs NICE_0_WEIGHT.
+const int NICE_0_WEIGHT = 1024;
+const int NICE_TO_WEIGHT[40] = {
+    88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906, 3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423, 335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45, 36, 29, 23, 18, 15,
+};
+
+// Completely Fair Scheduler. Each process accrues virtual runtime at NICE_0_WEIGHT / weight times real time, and
+// the one with the least runs next. Its slice is its weight's share of the scheduling period: target_latency,
+// stretched to min_granularity per runnable process once there are more than target_latency / min_granularity,
+// and never shorter than min_granularity. The run queue is an indexed heap on vruntime and the runnable weight is
+// kept as a running total, so nothing is O(n) in the number of runnable processes.
+//
+// A new process starts at min_vruntime, the floor under every runnable process's vruntime, so it neither gets
+// a backlog of credit nor waits behind everyone. It preempts the running process on arrival when the running one
+// is more than min_granularity (in the newcomer's virtual time) ahead of it. A process waking up from I/O keeps
+// its vruntime, but no less than half a target_latency behind min_vruntime: sleepers get a small head start
+// rather than credit for all the time they were away, as in Linux's place_entity().
+class CfsPolicy{
+public:
+    CfsPolicy(const ProcessTable& processes, int /*time_quantum*/, const SimulationOptions& options):
+      processes(processes), target_latency(std::max(1, options.target_latency)),
+      min_granularity(std::max(1, options.min_granularity)), weight(processes.size()), vruntime(processes.size(), 0){
+        for(size_t i = 0; i < processes.size(); ++i){
+            int nice = processes.nice.empty() ? 0 : std::clamp(processes.nice[i], -20, 19); // like setpriority()
+            weight[i] = NICE_TO_WEIGHT[nice + 20];
+        }
+        ready.reserveItems(processes.size());
+    }
+
+    void on_arrival(int proc, int now){
+        if(running != NO_PROCESS) updateMinVruntime(runningVruntime(running, now));
+        vruntime[proc] = min_vruntime;
+        total_weight += weight[proc];
+        enqueue(proc);
+    }
+
+    int on_dispatch(int now, int& slice){
+        if(ready.empty()) return NO_PROCESS;
+        running = ready.pop();
+        running_since = now; // until on_run says when it starts after the switch
+        updateMinVruntime(vruntime[running]);
+
+        long long runnable = static_cast<long long>(ready.size()) + 1;
+        long long period = std::max<long long>(target_latency, runnable * min_granularity);
+        long long share = std::max<long long>(min_granularity, period * weight[running] / total_weight);
+        slice = static_cast<int>(std::min<long long>(share, processes.remaining_time[running]));
+        return running;
+    }
+
+    void on_run(int /*proc*/, int start){ running_since = start; }
+
+    void on_tick(int proc, int ran, int /*now*/){
+        vruntime[proc] += virtualTime(ran, weight[proc]);
+        running = NO_PROCESS;
+        enqueue(proc);
+    }
+
+    void on_complete(int proc, int /*ran*/, int /*now*/){
+        running = NO_PROCESS;
+        total_weight -= weight[proc];
+    }
+
+    void on_block(int proc, int ran, int /*now*/){
+        vruntime[proc] += virtualTime(ran, weight[proc]);
+        running = NO_PROCESS;
+        total_weight -= weight[proc]; // not runnable while it waits
+    }
+
+    void on_wakeup(int proc, int now){
+        if(running != NO_PROCESS) updateMinVruntime(runningVruntime(running, now));
+        vruntime[proc] = std::max(vruntime[proc], min_vruntime - virtualTime(target_latency / 2, NICE_0_WEIGHT));
+        total_weight += weight[proc];
+        enqueue(proc);
+    }
+
+    bool should_preempt(int running_proc, int /*remaining*/, int now) const{
+        if(ready.empty()) return false;
+        long long current = runningVruntime(running_proc, now);
+        int waiting = ready.top();
+        return current - vruntime[waiting] > virtualTime(min_granularity, weight[waiting]);
+    }
+
+    // per_process is the vruntime of every process; counters are min_vruntime, total_weight, running and
+    // running_since
+    void save(PolicyState& state) const{
+        state.ready = ready.itemsInOrder();
+        state.per_process = vruntime;
+        state.counters = {min_vruntime, total_weight, running, running_since};
+    }
+
+    bool restore(const PolicyState& state){
+        if(state.per_process.size() > vruntime.size() || state.counters.size() != 4) return false;
+        std::copy(state.per_process.begin(), state.per_process.end(), vruntime.begin());
+        min_vruntime = state.counters[0];
+        total_weight = state.counters[1];
+        running = static_cast<int>(state.counters[2]);
+        running_since = static_cast<int>(state.counters[3]);
+        for(int proc : state.ready) enqueue(proc);
+        return true;
+    }
+
+private:
+    const ProcessTable& processes;
+    int target_latency, min_granularity;
+    std::vector<int> weight;
+    std::vector<long long> vruntime; // in 1/NICE_0_WEIGHT time units, so heavy processes still advance
+    IndexedDaryHeap<ReadyKey> ready; // keyed by vruntime
+    uint64_t next_seq = 0;
+    long long total_weight = 0; // of the ready processes and the running one, not the ones blocked on I/O
+    long long min_vruntime = 0; // never decreases
+    int running = NO_PROCESS;
+    int running_since = 0;
+
+    static long long virtualTime(long long ran, int weight){ return ran * NICE_0_WEIGHT * NICE_0_WEIGHT / weight; }
+
+    void enqueue(int proc){ ready.push(proc, ReadyKey{vruntime[proc], next_seq++}); }
+
+    // the running process's vruntime as of now; nothing accrues while the switch onto it is still being paid
+    long long runningVruntime(int proc, int now) const{
+        return vruntime[proc] + virtualTime(std::max(0, now - running_since), weight[proc]);
+    }
+
+    // the smallest vruntime among the runnable processes, given the running one's as of now
+    void updateMinVruntime(long long current){
+        long long smallest = ready.empty() ? current : std::min(current, ready.topKey().rank);
+        min_vruntime = std::max(min_vruntime, smallest);
+    }
+};
+
+// Multi-Level Feedback Queue. Every level is a FIFO with its own quantum; new processes start at the top, and the
+// highest non-empty level runs, picked in O(1) from a bitmask of non-empty levels whatever the number of levels.
+// A process is demoted one level once it has used up its level's quantum, counted across every time it ran
+// there, so giving up the CPU just before the timer fires doesn't keep it on top. An arrival at a higher level
+// preempts the running process, which stays on its level with the rest of its quantum. A process blocking on I/O
+// keeps its level and what it has used of the quantum, so an interactive process that blocks early stays on top.
+// Every boost_period time units all processes go back to the top level.
+//
+// The levels are linked lists threaded through one next[] array, so a boost splices each level onto the top in
+// O(1) and bumps boost_epoch; a process whose epoch is behind is at the top with a fresh quantum, and gets its
+// own fields brought up to date the next time it is touched. Boosts are applied at the first hook at or after
+// each boost time, which is the first moment they can change a decision.
+class MlfqPolicy{
+public:
+    MlfqPolicy(const ProcessTable& processes, int /*time_quantum*/, const SimulationOptions& options):
+      processes(processes), quanta(options.mlfq_quanta), boost_period(options.mlfq_boost_period),
+      next(processes.size(), NO_PROCESS), level(processes.size(), 0), used(processes.size(), 0), epoch(processes.size(), 0){
+        if(quanta.empty()) quanta.push_back(1);
+        if(quanta.size() > MLFQ_MAX_LEVELS) quanta.resize(MLFQ_MAX_LEVELS);
+        for(int& quantum : quanta) quantum = std::max(1, quantum);
+        levels.resize(quanta.size());
+        next_boost = boost_period > 0 ? boost_period : std::numeric_limits<long long>::max();
+    }
+
+    void on_arrival(int proc, int now){
+        boostIfDue(now);
+        level[proc] = 0;
+        used[proc] = 0;
+        epoch[proc] = boost_epoch;
+        pushBack(0, proc);
+    }
+
+    int on_dispatch(int now, int& slice){
+        boostIfDue(now);
+        if(non_empty == 0) return NO_PROCESS;
+        int proc = popFront(lowestSetBit(non_empty));
+        catchUp(proc);
+        slice = std::min(quanta[level[proc]] - used[proc], processes.remaining_time[proc]);
+        return proc;
+    }
+
+    void on_run(int /*proc*/, int /*start*/){}
+
+    void on_tick(int proc, int ran, int now){
+        charge(proc, ran, now);
+        pushBack(level[proc], proc);
+    }
+
+    void on_complete(int /*proc*/, int /*ran*/, int /*now*/){}
+
+    void on_block(int proc, int ran, int now){ charge(proc, ran, now); }
+
+    void on_wakeup(int proc, int now){
+        boostIfDue(now);
+        catchUp(proc);
+        pushBack(level[proc], proc);
+    }
+
+    bool should_preempt(int running_proc, int /*remaining*/, int /*now*/) const{
+        int running_level = epoch[running_proc] == boost_epoch ? level[running_proc] : 0;
+        return non_empty != 0 && lowestSetBit(non_empty) < running_level;
+    }
+
+    // The ready list is every level from the top, which is dispatch order as long as nothing arrives. per_process
+    // holds each process's level and quantum used, caught up with the latest boost, so a restored policy starts
+    // at epoch 0; counters hold next_boost.
+    void save(PolicyState& state) const{
+        for(const Level& waiting : levels){
+            for(int proc = waiting.head; proc != NO_PROCESS; proc = next[proc]) state.ready.push_back(proc);
+        }
+        state.per_process.reserve(2 * level.size());
+        for(size_t proc = 0; proc < level.size(); ++proc){
+            bool current = epoch[proc] == boost_epoch;
+            state.per_process.push_back(current ? level[proc] : 0);
+            state.per_process.push_back(current ? used[proc] : 0);
+        }
+        state.counters = {next_boost};
+    }
+
+    bool restore(const PolicyState& state){
+        if(state.per_process.size() % 2 || state.per_process.size() > 2 * level.size() || state.counters.size() != 1) return false;
+        int bottom = static_cast<int>(quanta.size()) - 1; // the quanta may have changed since the save
+        for(size_t proc = 0; proc < state.per_process.size() / 2; ++proc){
+            level[proc] = static_cast<int>(std::clamp<long long>(state.per_process[2 * proc], 0, bottom));
+            used[proc] = static_cast<int>(std::clamp<long long>(state.per_process[2 * proc + 1], 0, quanta[level[proc]] - 1));
+        }
+        if(boost_period > 0 && state.counters[0] != std::numeric_limits<long long>::max()) next_boost = state.counters[0];
+        for(int proc : state.ready) pushBack(level[proc], proc);
+        return true;
+    }
+
+private:
+    struct Level{
+        int head = NO_PROCESS, tail = NO_PROCESS;
+    };
+
+    const ProcessTable& processes;
+    std::vector<int> quanta;
+    long long boost_period, next_boost;
+    std::vector<Level> levels;
+    uint64_t non_empty = 0; // bit l set when level l has a process waiting
+    std::vector<int> next; // next process on the same level
+    std::vector<int> level, used, epoch; // per process: its level, quantum used there, and the boost it was set in
+    int boost_epoch = 0;
+
+    void pushBack(int l, int proc){
+        next[proc] = NO_PROCESS;
+        if(levels[l].tail == NO_PROCESS) levels[l].head = proc;
+        else next[levels[l].tail] = proc;
+        levels[l].tail = proc;
+        non_empty |= uint64_t(1) << l;
+    }
+
+    int popFront(int l){
+        int proc = levels[l].head;
+        levels[l].head = next[proc];
+        if(levels[l].head == NO_PROCESS){
+            levels[l].tail = NO_PROCESS;
+            non_empty &= ~(uint64_t(1) << l);
+        }
+        return proc;
+    }
+
+    // append every lower level to the top one, in level order, and start a new epoch
+    void boostIfDue(int now){
+        if(now < next_boost) return;
+        next_boost = (now / boost_period + 1) * boost_period;
+        ++boost_epoch;
+        uint64_t lower = non_empty & ~uint64_t(1);
+        while(lower != 0){
+            int l = lowestSetBit(lower);
+            lower &= lower - 1;
+            if(levels[0].tail == NO_PROCESS) levels[0].head = levels[l].head;
+            else next[levels[0].tail] = levels[l].head;
+            levels[0].tail = levels[l].tail;
+            levels[l] = Level();
+        }
+        if(non_empty != 0) non_empty = 1;
+    }
+
+    // count ran against proc's quantum, demoting it once the quantum is used up
+    void charge(int proc, int ran, int now){
+        boostIfDue(now);
+        catchUp(proc);
+        used[proc] += ran;
+        if(used[proc] >= quanta[level[proc]]){
+            level[proc] = std::min(level[proc] + 1, static_cast<int>(quanta.size()) - 1);
+            used[proc] = 0;
+        }
+    }
+
+    // a process last set before the latest boost is at the top with a fresh quantum
+    void catchUp(int proc){
+        if(epoch[proc] == boost_epoch) return;
+        level[proc] = 0;
+        used[proc] = 0;
+        epoch[proc] = boost_epoch;
+    }
+};
+
+#endif // POLICIES_H
@@ -0,0 +1,1886 @@
+#include "scheduler.h"
+#include "policies.h"
+
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// calculate data of the processes
+void calculateMetrics(ProcessTable& processes, float& avg_rt, float& avg_tat, float& avg_wt, float& cpu_efficiency, long long total_execution_time, long long total_switch_time){
+    long long total_tat = 0, total_wt = 0, total_rt = 0; // 64-bit, big traces overflow int
+
+    for(size_t i = 0; i < processes.size(); ++i){
+      // calculate times
+      processes.turnaround_time[i] = processes.end_time[i] - processes.arrival_time[i]; //TAT = waiting time + service time, such as in this case the TAT is the processes's time of completion the moment it arrives in the ready queue unti it completes its burst time plus additional waiting times from stuff like context switching, convoy effect, etc.
+      processes.waiting_time[i] = processes.turnaround_time[i] - static_cast<int>(processes.serviceTime(i)); //Waiting time = TAT- Service Time (CPU plus any I/O)
+      processes.response_time[i] = processes.start_time[i] - processes.arrival_time[i];
+
+      total_tat += processes.turnaround_time[i];
+      total_wt += processes.waiting_time[i];
+      total_rt += processes.response_time[i];
+
+    }
+
+    // Calculating average metrics and CPU efficiency.
+    avg_tat = static_cast<float>(total_tat) / processes.size();
+    avg_wt = static_cast<float>(total_wt) / processes.size();
+    avg_rt = static_cast<float>(total_rt) / processes.size();
+    cpu_efficiency = (static_cast<float>(total_execution_time) / (total_execution_time + total_switch_time)) * 100.0f; //efficient cpu utilization would have low execution times and low context swiitch times
+}
+//-------------------------------------------------------------------DISPLAY------------------------------------
+
+// Output buffer that formats numbers with to_chars into one large block and hands it to stdout (or another file)
+// a block at a time, instead of going through locale-aware iostream formatting for every field. Shares stdout
+// with cout (which is synced with stdio), so anything printed with cout before a flush comes out first.
+class OutputBuffer{
+public:
+    explicit OutputBuffer(size_t capacity = 1 << 20, FILE* out = stdout): buffer(capacity), out(out) {}
+    ~OutputBuffer(){ flush(); }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    // significant digits for doubles, like cout's precision; 0 prints the shortest form that reads back exactly
+    void setPrecision(int digits){ precision = digits; }
+
+    OutputBuffer& operator<<(const char* text){ return append(text, strlen(text)); }
+    OutputBuffer& operator<<(const string& text){ return append(text.data(), text.size()); }
+    OutputBuffer& operator<<(char c){ return append(&c, 1); }
+    OutputBuffer& operator<<(int value){ return number(value); }
+    OutputBuffer& operator<<(long value){ return number(value); }
+    OutputBuffer& operator<<(long long value){ return number(value); }
+    OutputBuffer& operator<<(unsigned long value){ return number(value); }
+    OutputBuffer& operator<<(unsigned long long value){ return number(value); }
+
+    OutputBuffer& operator<<(float value){ return floating(value); }
+    OutputBuffer& operator<<(double value){ return floating(value); }
+
+    void flush(){
+        if(used == 0) return;
+        fflush(stdout); // whatever cout already handed to stdio goes first
+        fwrite(buffer.data(), 1, used, out);
+        fflush(out);
+        used = 0;
+    }
+
+private:
+    static const size_t MAX_NUMBER_CHARS = 32;
+    vector<char> buffer;
+    FILE* out;
+    size_t used = 0;
+    int precision = 6;
+
+    void reserve(size_t n){
+        if(used + n > buffer.size()) flush();
+        if(n > buffer.size()) buffer.resize(n);
+    }
+
+    OutputBuffer& append(const char* text, size_t n){
+        reserve(n);
+        memcpy(buffer.data() + used, text, n);
+        used += n;
+        return *this;
+    }
+
+    template<class Floating>
+    OutputBuffer& floating(Floating value){
+        reserve(MAX_NUMBER_CHARS);
+        char* first = buffer.data() + used;
+        to_chars_result result = precision > 0
+            ? to_chars(first, first + MAX_NUMBER_CHARS, value, chars_format::general, precision)
+            : to_chars(first, first + MAX_NUMBER_CHARS, value);
+        used = result.ptr - buffer.data();
+        return *this;
+    }
+
+    template<class Integer>
+    OutputBuffer& number(Integer value){
+        reserve(MAX_NUMBER_CHARS);
+        used = to_chars(buffer.data() + used, buffer.data() + buffer.size(), value).ptr - buffer.data();
+        return *this;
+    }
+};
+
+// overall figures of a run, whichever way they were computed
+struct RunSummary{
+    long long completed, total_time;
+    float avg_tat, avg_wt, avg_rt, cpu_efficiency; // float, like calculateMetrics reports them
+    const StreamingMetrics* metrics; // percentiles, when available
+};
+
+void displayPercentiles(OutputBuffer& out, const StreamingMetrics& metrics){
+    auto line = [&out](const char* name, const LatencyHistogram& histogram){
+        out << name << " p50/p99/p999: " << histogram.percentile(50) << " / " << histogram.percentile(99) << " / "
+            << histogram.percentile(99.9) << " time units\n";
+    };
+    line("Turn Around Time", metrics.turnaround);
+    line("Waiting Time", metrics.waiting);
+    line("Response Time", metrics.response);
+}
+
+// summary as one CSV row (after its header) or one JSON object line; JSON keys match the web UI's SimulationResult
+void writeSummaryRecord(OutputBuffer& out, OutputFormat format, const RunSummary& summary){
+    static const char* const METRIC_NAMES[] = {"turnaround", "waiting", "response"};
+    static const double PERCENTILES[] = {50, 99, 99.9};
+    static const char* const PERCENTILE_NAMES[] = {"P50", "P99", "P999"};
+    const LatencyHistogram* histograms[3] = {nullptr, nullptr, nullptr};
+    if(summary.metrics){
+        histograms[0] = &summary.metrics->turnaround;
+        histograms[1] = &summary.metrics->waiting;
+        histograms[2] = &summary.metrics->response;
+    }
+
+    if(format == OutputFormat::CSV){
+        out << "processes,totalTime,avgTurnaroundTime,avgWaitingTime,avgResponseTime,cpuEfficiency";
+        for(int m = 0; m < 3 && summary.metrics; ++m){
+            for(int q = 0; q < 3; ++q) out << ',' << METRIC_NAMES[m] << PERCENTILE_NAMES[q];
+        }
+        out << "\n" << summary.completed << ',' << summary.total_time << ',' << summary.avg_tat << ',' << summary.avg_wt
+            << ',' << summary.avg_rt << ',' << summary.cpu_efficiency;
+        for(int m = 0; m < 3 && summary.metrics; ++m){
+            for(int q = 0; q < 3; ++q) out << ',' << histograms[m]->percentile(PERCENTILES[q]);
+        }
+        out << "\n";
+        return;
+    }
+
+    out << "{\"processes\":" << summary.completed << ",\"totalTime\":" << summary.total_time
+        << ",\"avgTurnaroundTime\":" << summary.avg_tat << ",\"avgWaitingTime\":" << summary.avg_wt
+        << ",\"avgResponseTime\":" << summary.avg_rt << ",\"cpuEfficiency\":" << summary.cpu_efficiency;
+    for(int m = 0; m < 3 && summary.metrics; ++m){
+        for(int q = 0; q < 3; ++q){
+            out << ",\"" << METRIC_NAMES[m] << PERCENTILE_NAMES[q] << "\":"
+                << histograms[m]->percentile(PERCENTILES[q]);
+        }
+    }
+    out << "}\n";
+}
+
+// display the calculated results
+void displayResults(const ProcessTable& processes, const float avg_rt, const float avg_tat, const float avg_wt, const float cpu_efficiency, OutputFormat format){
+    OutputBuffer out;
+    // the latest completion: under SJF, SRTF, CFS or MLFQ that's often not the last process listed
+    long long total_time = processes.metrics ? processes.metrics->makespan
+                         : processes.end_time.empty() ? 0 : *max_element(processes.end_time.begin(), processes.end_time.end());
+
+    if(format == OutputFormat::CSV){
+        out.setPrecision(0);
+        out << "id,arrivalTime,burstTime,startTime,endTime,turnaroundTime,waitingTime,responseTime\n";
+        for(size_t i = 0; i < processes.size(); ++i){
+            out << processes.p_id[i] << ',' << processes.arrival_time[i] << ',' << processes.burst_time[i] << ','
+                << processes.start_time[i] << ',' << processes.end_time[i] << ',' << processes.turnaround_time[i] << ','
+                << processes.waiting_time[i] << ',' << processes.response_time[i] << '\n';
+        }
+        return;
+    }
+
+    if(format == OutputFormat::JSONL){
+        // first line is the summary, then one object per process
+        out.setPrecision(0);
+        writeSummaryRecord(out, format, RunSummary{static_cast<long long>(processes.size()), total_time, avg_tat, avg_wt,
+                                                   avg_rt, cpu_efficiency, processes.metrics});
+        for(size_t i = 0; i < processes.size(); ++i){
+            out << "{\"id\":" << processes.p_id[i] << ",\"arrivalTime\":" << processes.arrival_time[i]
+                << ",\"burstTime\":" << processes.burst_time[i] << ",\"startTime\":" << processes.start_time[i]
+                << ",\"endTime\":" << processes.end_time[i] << ",\"turnaroundTime\":" << processes.turnaround_time[i]
+                << ",\"waitingTime\":" << processes.waiting_time[i] << ",\"responseTime\":" << processes.response_time[i] << "}\n";
+        }
+        return;
+    }
+
+    out << "Total Time required is " << total_time << " time units\n";
+    out << "Average Turn Around Time: " << avg_tat << " time units\n";
+    out << "Average Waiting Time: " << avg_wt << " time units\n";
+    out << "Average Response Time: " << avg_rt << " time units\n";
+    out << "CPU Efficiency: " << cpu_efficiency << "%\n";
+    if(processes.metrics) displayPercentiles(out, *processes.metrics);
+    out << "\n";
+
+    // Displaying details for each process.
+    for(size_t i = 0; i < processes.size(); ++i){
+      out << "Process " << processes.p_id[i] << ":\n";
+      out << "Service time = " << processes.serviceTime(i) << " time units\n"; // CPU plus any I/O
+      out << "Turnaround time = " << processes.turnaround_time[i] << " time units\n";
+      out << "Waiting time = " << processes.waiting_time[i] << " time units\n";
+      out << "Response time = " << processes.response_time[i] << " time units\n\n";
+    }
+}
+
+// a process starts the first time it is dispatched; later dispatches resume it
+inline bool firstDispatch(const ProcessTable& processes, int proc){
+    if(processes.io.empty()) return processes.remaining_time[proc] == processes.burst_time[proc];
+    return processes.next_io[proc] == 0 && processes.remaining_time[proc] == processes.firstBurst(proc);
+}
+
+// Dense indices in the order arrivals are delivered: by time, then by position in the table. The event-driven
+// engines walk this instead of pushing every arrival up front, so their event queues only hold the slices in
+// flight; taking an arrival before any queued event at the same time gives the order the up-front pushes did.
+vector<int> arrivalOrder(const ProcessTable& processes){
+    const IntColumn& arrival_time = processes.arrival_time;
+    vector<int> order(processes.size());
+    for(size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    bool sorted = true; // workloads usually come sorted already
+    for(size_t i = 1; i < order.size() && sorted; ++i) sorted = arrival_time[i - 1] <= arrival_time[i];
+    if(!sorted) stable_sort(order.begin(), order.end(), [&](int a, int b){ return arrival_time[a] < arrival_time[b]; });
+    return order;
+}
+
+// Prices dispatches with a SwitchCostModel: remembers whose context each CPU holds and, when there is a warmup
+// penalty, when and where every process last came off a CPU. Counts the switches into the ProcessTable.
+class SwitchCostTracker{
+public:
+    SwitchCostTracker(const SwitchCostModel& model, ProcessTable& processes, int cores = 1):
+      model(model), processes(processes), loaded(cores, NO_PROCESS){
+        if(model.warmup > 0){
+            left_at.assign(processes.size(), 0);
+            left_core.assign(processes.size(), -1);
+        }
+    }
+
+    // switch time before proc can run on core at now: none when the core still holds its context
+    int dispatch(int core, int proc, int now){
+        if(loaded[core] == proc) return 0;
+        loaded[core] = proc;
+        long long off_for = SwitchCostModel::COLD;
+        if(!left_core.empty() && left_core[proc] == core) off_for = now - left_at[proc];
+        int cost = model.cost(off_for);
+        ++processes.switches;
+        processes.switch_time += cost;
+        return cost;
+    }
+
+    // the switch onto core, paid up to until, was cut short at now by a preemption: refund the rest and don't count
+    // it, and since the context never finished loading, the next dispatch onto core pays a full switch
+    void abandon(int core, int until, int now){
+        if(until <= now) return;
+        --processes.switches;
+        processes.switch_time -= until - now;
+        loaded[core] = NO_PROCESS;
+    }
+
+    // proc came off core at now, still needing more time
+    void leave(int core, int proc, int now){
+        if(left_core.empty()) return;
+        left_at[proc] = now;
+        left_core[proc] = core;
+    }
+
+    int loadedOn(int core) const{ return loaded[core]; }
+
+    // single CPU: for a snapshot, and back from one whose table may have had processes added since, which start cold
+    void save(SimulationSnapshot& snapshot) const{
+        snapshot.loaded = loaded[0];
+        snapshot.left_at = left_at;
+        snapshot.left_core = left_core;
+    }
+
+    void restore(const SimulationSnapshot& snapshot){
+        loaded[0] = snapshot.loaded;
+        if(left_core.empty() || snapshot.left_at.size() != snapshot.left_core.size()) return; // no warmup on one side
+        size_t saved = min(snapshot.left_core.size(), left_core.size());
+        copy_n(snapshot.left_at.begin(), saved, left_at.begin());
+        copy_n(snapshot.left_core.begin(), saved, left_core.begin());
+    }
+
+private:
+    const SwitchCostModel& model;
+    ProcessTable& processes;
+    vector<int> loaded; // process whose context each core holds
+    vector<int> left_at, left_core; // only kept when there is a warmup penalty
+};
+
+// FNV-1a over the first count processes' arrival and burst times, so a snapshot is only resumed on its workload
+uint64_t workloadHash(const ProcessTable& processes, size_t count){
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < count; ++i){
+        hash = (hash ^ static_cast<uint32_t>(processes.arrival_time[i])) * 1099511628211ULL;
+        hash = (hash ^ static_cast<uint32_t>(processes.burst_time[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Event-driven simulation of one CPU on any of the event queues, with every scheduling decision left to the
+// policy (see policies.h). A dispatch that switches contexts keeps the CPU busy for the switch cost before the
+// process starts, and a preemption during a switch abandons the rest of it. Processes with I/O steps block at the
+// end of each CPU burst but the last and queue FIFO on their device, which serves one request at a time (or just
+// sleep, on SLEEP_DEVICE); when their I/O is done they are ready for their next burst. The run can stop before
+// any instant and carry on later, and be saved to and restored from a SimulationSnapshot in between.
+template<class EventQueue, class Policy>
+class PolicyEngine{
+public:
+    PolicyEngine(ProcessTable& processes, Policy& policy, const SwitchCostModel& switch_cost):
+      processes(processes), policy(policy), switches(switch_cost, processes), arrivals(arrivalOrder(processes)),
+      remaining_time(processes.remaining_time), next_io(processes.next_io), io(processes.io), has_io(!io.empty()),
+      trace(processes.trace), stats(processes.stats){
+        processes.resetRunState();
+        device_queue.resize(processes.device_busy_time.size());
+    }
+
+    // handle every event before limit; true once there is nothing left to handle
+    bool runUntil(long long limit){
+        const IntColumn& arrival_time = processes.arrival_time;
+
+        // Simulation loop processing each event in chronological order.
+        while(next_arrival < arrivals.size() || !event_queue.empty()){
+            if(next_arrival < arrivals.size() && (event_queue.empty() || arrival_time[arrivals[next_arrival]] <= event_queue.top().event_time)){
+                int proc = arrivals[next_arrival];
+                int current_time = arrival_time[proc];
+                if(current_time >= limit) return false;
+                ++next_arrival;
+                ++processes.events;
+                sample(EventType::ARRIVAL);
+                if(has_io) account(current_time);
+                policy.on_arrival(proc, current_time);
+                readied(1);
+                ready(current_time);
+                continue;
+            }
+
+            Event event = event_queue.top();
+            int current_time = event.event_time;
+            if(current_time >= limit) return false;
+            ++processes.events;
+            sample(event.type);
+            event_queue.pop();
+            if(has_io) account(current_time);
+
+            if(event.type == EventType::UNBLOCK){
+                // the device is done with proc: on to its next CPU burst, and to the next request in line
+                int proc = event.process;
+                const IoStep& step = io.begin(proc)[next_io[proc]++];
+                if(step.device != SLEEP_DEVICE){
+                    queue<int>& waiting = device_queue[step.device];
+                    waiting.pop();
+                    if(waiting.empty()) --busy_devices;
+                    else startIo(step.device, current_time);
+                }
+                remaining_time[proc] = step.cpu_time;
+                policy.on_wakeup(proc, current_time);
+                readied(1);
+                ready(current_time);
+                continue;
+            }
+
+            // COMPLETION, TIME_SLICE or BLOCK: the running slice is over
+            int proc = current_process;
+            remaining_time[proc] -= current_slice;
+            if(event.type == EventType::BLOCK){
+                TRACE_EVENT(trace, TraceKind::BLOCK, current_time, proc, current_slice);
+                switches.leave(0, proc, current_time);
+                policy.on_block(proc, current_slice, current_time);
+                block(proc, current_time);
+            }else if(remaining_time[proc] == 0){
+                TRACE_EVENT(trace, TraceKind::COMPLETE, current_time, proc, current_slice);
+                finish(proc, current_time);
+                policy.on_complete(proc, current_slice, current_time);
+            }else{
+                TRACE_EVENT(trace, TraceKind::TIMER, current_time, proc, current_slice);
+                switches.leave(0, proc, current_time);
+                policy.on_tick(proc, current_slice, current_time); // preempted, ready again
+                readied(1);
+            }
+            current_process = NO_PROCESS;
+            dispatch(current_time);
+        }
+        return true;
+    }
+
+    long long totalExecutionTime() const{ return total_execution_time; }
+
+    // everything but the policy's name, quantum and the snapshot's time, which the caller knows
+    void save(SimulationSnapshot& snapshot) const{
+        snapshot.process_count = processes.size();
+        snapshot.workload_hash = workloadHash(processes, processes.size());
+        snapshot.next_arrival = next_arrival;
+        snapshot.current_process = current_process;
+        snapshot.current_slice = current_slice;
+        snapshot.slice_start = slice_start;
+        snapshot.pending = event_queue.pending();
+        snapshot.device_queues.assign(device_queue.size(), {});
+        for(size_t device = 0; device < device_queue.size(); ++device){
+            for(queue<int> waiting = device_queue[device]; !waiting.empty(); waiting.pop()) snapshot.device_queues[device].push_back(waiting.front());
+        }
+        snapshot.busy_devices = busy_devices;
+        snapshot.last_time = last_time;
+        snapshot.total_execution_time = total_execution_time;
+        snapshot.policy_state = PolicyState();
+        policy.save(snapshot.policy_state);
+        switches.save(snapshot);
+
+        snapshot.keep_records = processes.keep_records;
+        snapshot.remaining_time = processes.remaining_time;
+        snapshot.start_time = processes.start_time;
+        snapshot.end_time = processes.end_time;
+        snapshot.next_io = processes.next_io;
+        snapshot.events = processes.events;
+        snapshot.switches = processes.switches;
+        snapshot.switch_time = processes.switch_time;
+        snapshot.cpu_busy_time = processes.cpu_busy_time;
+        snapshot.overlap_time = processes.overlap_time;
+        snapshot.device_busy_time = processes.device_busy_time;
+        snapshot.has_metrics = processes.metrics != nullptr;
+        snapshot.metrics = processes.metrics ? *processes.metrics : StreamingMetrics();
+    }
+
+    // Carry on from a snapshot of a table this one extends (checked by resumeSimulation). With the policy that
+    // saved it, exactly where it was; another policy takes over at the snapshot's time with the running process
+    // preempted, then the saved ready list in order.
+    bool restore(const SimulationSnapshot& snapshot, bool same_policy){
+        copy(snapshot.remaining_time.begin(), snapshot.remaining_time.end(), processes.remaining_time.begin());
+        copy(snapshot.start_time.begin(), snapshot.start_time.end(), processes.start_time.begin());
+        copy(snapshot.end_time.begin(), snapshot.end_time.end(), processes.end_time.begin());
+        copy(snapshot.next_io.begin(), snapshot.next_io.end(), processes.next_io.begin());
+        copy_n(snapshot.device_busy_time.begin(), min(snapshot.device_busy_time.size(), processes.device_busy_time.size()),
+               processes.device_busy_time.begin());
+        processes.events = snapshot.events;
+        processes.switches = snapshot.switches;
+        processes.switch_time = snapshot.switch_time;
+        processes.cpu_busy_time = snapshot.cpu_busy_time;
+        processes.overlap_time = snapshot.overlap_time;
+        if(processes.metrics) *processes.metrics = snapshot.metrics;
+        switches.restore(snapshot);
+        readied(static_cast<int>(snapshot.policy_state.ready.size()));
+
+        for(size_t device = 0; device < snapshot.device_queues.size(); ++device){
+            for(int proc : snapshot.device_queues[device]) device_queue[device].push(proc);
+        }
+        for(const Event& event : snapshot.pending){
+            EventHandle handle = event_queue.push(event);
+            if(event.type != EventType::UNBLOCK) slice_event = handle;
+        }
+        next_arrival = snapshot.next_arrival;
+        current_process = snapshot.current_process;
+        current_slice = snapshot.current_slice;
+        slice_start = snapshot.slice_start;
+        busy_devices = snapshot.busy_devices;
+        last_time = snapshot.last_time;
+        total_execution_time = snapshot.total_execution_time;
+        if(same_policy) return policy.restore(snapshot.policy_state);
+
+        int now = static_cast<int>(min<long long>(snapshot.time, numeric_limits<int>::max()));
+        if(has_io) account(now);
+        if(current_process != NO_PROCESS){
+            int proc = current_process;
+            event_queue.cancel(slice_event);
+            int ran = max(0, now - slice_start);
+            switches.abandon(0, slice_start, now);
+            remaining_time[proc] -= ran;
+            current_process = NO_PROCESS;
+            TRACE_EVENT(trace, remaining_time[proc] > 0 ? TraceKind::PREEMPT : blocks(proc) ? TraceKind::BLOCK : TraceKind::COMPLETE, now, proc, ran);
+            if(remaining_time[proc] > 0){
+                switches.leave(0, proc, now);
+                policy.on_arrival(proc, now);
+                readied(1);
+            }else if(blocks(proc)){
+                // its slice ends right at now: it goes off to I/O or finishes without the new policy ever having it
+                switches.leave(0, proc, now);
+                block(proc, now);
+            }else{
+                finish(proc, now);
+            }
+        }
+        for(int proc : snapshot.policy_state.ready) policy.on_arrival(proc, now);
+        dispatch(now);
+        return true;
+    }
+
+private:
+    ProcessTable& processes;
+    Policy& policy;
+    SwitchCostTracker switches;
+    EventQueue event_queue; // the end of the running slice, and the I/O in service on each device
+    vector<int> arrivals;
+    size_t next_arrival = 0;
+    int current_process = NO_PROCESS; // index of the process currently on the CPU
+    int current_slice = 0; // how long it was given
+    int slice_start = 0; // when it starts running, after any context switch
+    EventHandle slice_event = 0; // the pending end of its slice
+    long long total_execution_time = 0; // total execution time for CPU efficiency calculation
+
+    vector<int>& remaining_time;
+    vector<int>& next_io;
+    const IoColumn& io;
+    bool has_io;
+    vector<queue<int>> device_queue; // front is in service
+    int busy_devices = 0;
+    int last_time = 0; // busy time is accounted up to here
+    ExecutionTrace* trace;
+    SimulatorStats* stats;
+    size_t ready_count = 0; // processes in the policy's ready set, only kept up with stats
+
+    // --stats only: count the event coming up and how deep the queues are as it does
+    void sample(EventType type){
+        if(stats) stats->sample(type, event_queue.size(), ready_count);
+    }
+
+    // --stats only: count processes joining (or with a negative count, leaving) the ready set
+    void readied(int count){
+        if(stats) ready_count += count;
+    }
+
+    // I/O runs only: charge the time since the last event to whatever was busy through it
+    void account(int now){
+        long long dt = now - last_time;
+        last_time = now;
+        if(current_process == NO_PROCESS) return;
+        processes.cpu_busy_time += dt;
+        if(busy_devices > 0) processes.overlap_time += dt;
+    }
+
+    // start serving the request at the front of device's queue
+    void startIo(int device, int now){
+        int proc = device_queue[device].front();
+        const IoStep& step = io.begin(proc)[next_io[proc]];
+        processes.device_busy_time[device] += step.io_time;
+        event_queue.push(Event(now + step.io_time, EventType::UNBLOCK, proc));
+    }
+
+    // whether proc goes off to I/O at the end of its current CPU burst
+    bool blocks(int proc) const{ return has_io && static_cast<size_t>(next_io[proc]) < io.stepCount(proc); }
+
+    // proc ran out its CPU burst at now: send it to its next I/O step
+    void block(int proc, int now){
+        const IoStep& step = io.begin(proc)[next_io[proc]];
+        int device = step.device;
+        if(device == SLEEP_DEVICE){
+            event_queue.push(Event(now + step.io_time, EventType::UNBLOCK, proc)); // nothing to queue for
+        }else if(device_queue[device].push(proc), device_queue[device].size() == 1){
+            ++busy_devices;
+            startIo(device, now);
+        }
+    }
+
+    void finish(int proc, int now){
+        processes.complete(proc, now); // mark the completion time of the process
+        total_execution_time += processes.burst_time[proc];
+    }
+
+    // put the next ready process (if any) on the idle CPU and schedule the end of its slice
+    void dispatch(int now){
+        int slice = 0;
+        int proc = policy.on_dispatch(now, slice);
+        if(proc == NO_PROCESS) return;
+        readied(-1);
+        current_process = proc;
+        current_slice = slice;
+        slice_start = now + switches.dispatch(0, proc, now);
+        policy.on_run(proc, slice_start);
+        TRACE_EVENT(trace, TraceKind::DISPATCH, now, proc, slice_start - now);
+        if(firstDispatch(processes, proc)) processes.start_time[proc] = slice_start; // response time counts from the first dispatch only
+        EventType type = EventType::TIME_SLICE;
+        if(slice == remaining_time[proc]) type = blocks(proc) ? EventType::BLOCK : EventType::COMPLETION;
+        slice_event = event_queue.push(Event(slice_start + slice, type, proc));
+    }
+
+    // a process just became ready: give it the idle CPU, or ask the policy whether it takes the CPU
+    void ready(int now){
+        if(current_process == NO_PROCESS){
+            dispatch(now);
+        }else if(now < slice_start + current_slice &&
+                 policy.should_preempt(current_process, remaining_time[current_process] - max(0, now - slice_start), now)){
+            // cut the running slice short: its pending end is dropped, not left to be skipped later
+            event_queue.cancel(slice_event);
+            int ran = max(0, now - slice_start);
+            switches.abandon(0, slice_start, now);
+            remaining_time[current_process] -= ran;
+            TRACE_EVENT(trace, TraceKind::PREEMPT, now, current_process, ran);
+            if(stats) ++stats->preemptions;
+            switches.leave(0, current_process, now);
+            policy.on_tick(current_process, ran, now);
+            readied(1);
+            current_process = NO_PROCESS;
+            dispatch(now);
+        }
+    }
+};
+
+// Runs the whole workload in one go. Returns the total CPU execution time.
+template<class EventQueue, class Policy>
+long long simulatePolicy(ProcessTable& processes, Policy& policy, const SwitchCostModel& switch_cost){
+    PolicyEngine<EventQueue, Policy> engine(processes, policy, switch_cost);
+    engine.runUntil(numeric_limits<long long>::max());
+    return engine.totalExecutionTime();
+}
+
+template<class Policy, class EventQueue>
+long long runPolicy(ProcessTable& processes, int time_quantum, const SimulationOptions& options){
+    Policy policy(processes, time_quantum, options);
+    return simulatePolicy<EventQueue>(processes, policy, options.switch_cost);
+}
+
+// every single-CPU instantiation, picked once per run by policy and event queue rather than branched on per event
+using PolicySimulator = long long (*)(ProcessTable& processes, int time_quantum, const SimulationOptions& options);
+const PolicySimulator POLICY_SIMULATORS[][2] = {
+    {runPolicy<FcfsPolicy, HeapEventQueue>, runPolicy<FcfsPolicy, CalendarEventQueue>}, // SchedulingPolicy::FCFS
+    {runPolicy<RoundRobinPolicy, HeapEventQueue>, runPolicy<RoundRobinPolicy, CalendarEventQueue>}, // SchedulingPolicy::RR
+    {runPolicy<SjfPolicy, HeapEventQueue>, runPolicy<SjfPolicy, CalendarEventQueue>}, // SchedulingPolicy::SJF
+    {runPolicy<SrtfPolicy, HeapEventQueue>, runPolicy<SrtfPolicy, CalendarEventQueue>}, // SchedulingPolicy::SRTF
+    {runPolicy<CfsPolicy, HeapEventQueue>, runPolicy<CfsPolicy, CalendarEventQueue>}, // SchedulingPolicy::CFS
+    {runPolicy<MlfqPolicy, HeapEventQueue>, runPolicy<MlfqPolicy, CalendarEventQueue>}, // SchedulingPolicy::MLFQ
+};
+
+PolicySimulator policySimulator(SchedulingPolicy policy, EventQueueKind queue_kind){
+    return POLICY_SIMULATORS[static_cast<int>(policy)][queue_kind == EventQueueKind::CALENDAR ? 1 : 0];
+}
+
+// a PolicyEngine together with the policy and switch cost model it runs on
+template<class Policy, class EventQueue>
+class PolicyStepper : public SteppedSimulation{
+public:
+    PolicyStepper(ProcessTable& processes, int time_quantum, SchedulingPolicy kind, const SimulationOptions& options):
+      kind(kind), time_quantum(time_quantum), switch_cost(options.switch_cost), policy(processes, time_quantum, options),
+      engine(processes, policy, switch_cost) {}
+
+    bool runUntil(long long time) override{
+        paused_at = time;
+        return engine.runUntil(time);
+    }
+
+    void save(SimulationSnapshot& snapshot) const override{
+        snapshot.policy = kind;
+        snapshot.time_quantum = time_quantum;
+        snapshot.time = paused_at;
+        engine.save(snapshot);
+    }
+
+    long long totalExecutionTime() const override{ return engine.totalExecutionTime(); }
+
+    bool restore(const SimulationSnapshot& snapshot){
+        paused_at = snapshot.time;
+        return engine.restore(snapshot, snapshot.policy == kind);
+    }
+
+private:
+    SchedulingPolicy kind;
+    int time_quantum;
+    SwitchCostModel switch_cost;
+    Policy policy;
+    PolicyEngine<EventQueue, Policy> engine;
+    long long paused_at = 0;
+};
+
+// a new stepper, resumed from snapshot when there is one; nullptr when the policy can't take the snapshot's state
+template<class Policy, class EventQueue>
+unique_ptr<SteppedSimulation> makeStepper(ProcessTable& processes, int time_quantum, SchedulingPolicy kind,
+                                          const SimulationOptions& options, const SimulationSnapshot* snapshot){
+    auto stepper = make_unique<PolicyStepper<Policy, EventQueue>>(processes, time_quantum, kind, options);
+    if(snapshot && !stepper->restore(*snapshot)) return nullptr;
+    return stepper;
+}
+
+using StepperFactory = unique_ptr<SteppedSimulation> (*)(ProcessTable& processes, int time_quantum, SchedulingPolicy kind,
+                                                        const SimulationOptions& options, const SimulationSnapshot* snapshot);
+const StepperFactory POLICY_STEPPERS[][2] = {
+    {makeStepper<FcfsPolicy, HeapEventQueue>, makeStepper<FcfsPolicy, CalendarEventQueue>},
+    {makeStepper<RoundRobinPolicy, HeapEventQueue>, makeStepper<RoundRobinPolicy, CalendarEventQueue>},
+    {makeStepper<SjfPolicy, HeapEventQueue>, makeStepper<SjfPolicy, CalendarEventQueue>},
+    {makeStepper<SrtfPolicy, HeapEventQueue>, makeStepper<SrtfPolicy, CalendarEventQueue>},
+    {makeStepper<CfsPolicy, HeapEventQueue>, makeStepper<CfsPolicy, CalendarEventQueue>},
+    {makeStepper<MlfqPolicy, HeapEventQueue>, makeStepper<MlfqPolicy, CalendarEventQueue>},
+};
+
+StepperFactory stepperFactory(SchedulingPolicy policy, EventQueueKind queue_kind){
+    return POLICY_STEPPERS[static_cast<int>(policy)][queue_kind == EventQueueKind::CALENDAR ? 1 : 0];
+}
+
+// why snapshot can't be resumed on processes, or nullptr; checks everything the engine indexes with, since a
+// snapshot may have been read from a file
+const char* snapshotProblem(const SimulationSnapshot& snapshot, const ProcessTable& processes){
+    size_t count = snapshot.process_count;
+    if(count > processes.size() || snapshot.workload_hash != workloadHash(processes, count)){
+        return "the snapshot was taken on a different workload";
+    }
+    for(size_t i = count; i < processes.size(); ++i){
+        if(processes.arrival_time[i] < snapshot.time) return "added processes must arrive at or after the snapshot's time";
+    }
+    if(snapshot.remaining_time.size() != count || snapshot.start_time.size() != count ||
+       snapshot.end_time.size() != (snapshot.keep_records ? count : 0) ||
+       snapshot.next_io.size() != (processes.io.empty() ? 0 : count) ||
+       snapshot.device_queues.size() > static_cast<size_t>(processes.io.deviceCount()) ||
+       snapshot.next_arrival > count) return "the snapshot is inconsistent";
+    auto valid = [count](long long proc){ return proc >= 0 && static_cast<uint64_t>(proc) < count; };
+    if(snapshot.current_process != NO_PROCESS && !valid(snapshot.current_process)) return "the snapshot is inconsistent";
+    size_t slices = 0;
+    for(const Event& event : snapshot.pending){
+        if(!valid(event.process)) return "the snapshot is inconsistent";
+        slices += event.type != EventType::UNBLOCK;
+    }
+    if(slices != (snapshot.current_process == NO_PROCESS ? 0u : 1u)) return "the snapshot is inconsistent";
+    for(const auto& waiting : snapshot.device_queues){
+        if(!all_of(waiting.begin(), waiting.end(), valid)) return "the snapshot is inconsistent";
+    }
+    const vector<int>& ready = snapshot.policy_state.ready;
+    if(!all_of(ready.begin(), ready.end(), valid)) return "the snapshot is inconsistent";
+    if(processes.metrics && !snapshot.has_metrics) return "the snapshot has no metrics to carry on from";
+    return nullptr;
+}
+
+unique_ptr<SteppedSimulation> startSimulation(ProcessTable& processes, int time_quantum, SchedulingPolicy policy,
+                                              const SimulationOptions& options, string& error){
+    if(options.cores > 1){
+        error = "stepped runs are single-CPU only";
+        return nullptr;
+    }
+    if(const char* problem = unsupportedRun(processes, policy, options)){
+        error = problem;
+        return nullptr;
+    }
+    return stepperFactory(policy, options.queue_kind)(processes, time_quantum, policy, options, nullptr);
+}
+
+unique_ptr<SteppedSimulation> resumeSimulation(const SimulationSnapshot& snapshot, ProcessTable& processes,
+                                               int time_quantum, SchedulingPolicy policy,
+                                               const SimulationOptions& options, string& error){
+    if(options.cores > 1){
+        error = "stepped runs are single-CPU only";
+        return nullptr;
+    }
+    const char* problem = unsupportedRun(processes, policy, options);
+    if(!problem) problem = snapshotProblem(snapshot, processes);
+    if(problem){
+        error = problem;
+        return nullptr;
+    }
+    processes.keep_records = snapshot.keep_records;
+    auto stepper = stepperFactory(policy, options.queue_kind)(processes, time_quantum, policy, options, &snapshot);
+    if(!stepper) error = string("the snapshot's scheduler state doesn't fit ") + policyName(policy);
+    return stepper;
+}
+
+// Round Robin without an event per quantum. While the ready set doesn't change, every process runs one full
+// quantum per round and the round order stays the same, so whole rounds can be skipped in closed form: k
+// processes can run floor((shortest remaining - 1) / quantum) rounds before anyone finishes, as long as no
+// arrival lands inside them. Produces the same start_time/end_time as simulatePolicy() with RoundRobinPolicy.
+// Rounds are only skipped while every slice costs the same switch: a lone process keeping the CPU switches
+// nothing, and several alternating ones pay the fixed cost each slice as long as there is no warmup penalty.
+long long simulateRoundRobinFastForward(ProcessTable& processes, int time_quantum, const SwitchCostModel& switch_cost){
+    processes.resetRunState();
+    SwitchCostTracker switches(switch_cost, processes);
+    vector<int>& remaining_time = processes.remaining_time;
+    vector<int>& start_time = processes.start_time;
+    const IntColumn& arrival_time = processes.arrival_time;
+
+    vector<int> arrivals = arrivalOrder(processes);
+
+    deque<int> ready_queue; // ready queue of dense process indices, front runs next
+    size_t next_arrival = 0;
+    long long current_time = 0;
+    long long total_execution_time = 0;
+    bool ready_set_changed = true; // only try to skip rounds after an arrival or completion
+
+    auto admit = [&](long long until){
+        while(next_arrival < arrivals.size() && arrival_time[arrivals[next_arrival]] <= until){
+            ready_queue.push_back(arrivals[next_arrival++]);
+            ready_set_changed = true;
+            ++processes.events;
+        }
+    };
+
+    while(true){
+        admit(current_time);
+        if(ready_queue.empty()){
+            if(next_arrival == arrivals.size()) break;
+            current_time = arrival_time[arrivals[next_arrival]]; // CPU idles until the next arrival
+            continue;
+        }
+
+        bool lone = ready_queue.size() == 1 && switches.loadedOn(0) == ready_queue.front();
+        bool alternating = ready_queue.size() > 1 && switch_cost.warmup == 0 && switches.loadedOn(0) != ready_queue.front();
+        if(ready_set_changed && time_quantum > 0 && (lone || alternating)){
+            ready_set_changed = false;
+            long long k = static_cast<long long>(ready_queue.size());
+            long long slice_cost = lone ? 0 : switch_cost.fixed;
+            long long round_length = k * (time_quantum + slice_cost);
+            long long rounds = numeric_limits<long long>::max();
+            if(next_arrival < arrivals.size()){
+                // the last slice of the last skipped round must end before the next arrival
+                rounds = (arrival_time[arrivals[next_arrival]] - current_time - 1) / round_length;
+            }
+            if(rounds > 0){
+                int shortest = *min_element(ready_queue.begin(), ready_queue.end(),
+                                            [&](int a, int b){ return remaining_time[a] < remaining_time[b]; });
+                rounds = min<long long>(rounds, (remaining_time[shortest] - 1) / time_quantum);
+            }
+            if(rounds > 0){
+                long long position = 0;
+                for(int proc : ready_queue){
+                    long long started = current_time + position * (time_quantum + slice_cost) + slice_cost;
+                    if(firstDispatch(processes, proc)) start_time[proc] = static_cast<int>(started);
+                    remaining_time[proc] -= static_cast<int>(rounds * time_quantum);
+                    ++position;
+                }
+                current_time += rounds * round_length;
+                processes.events += rounds * k; // the slices skipped over
+                if(alternating){
+                    // the front still isn't the loaded process afterwards, so the tracker prices the next dispatch right
+                    processes.switches += rounds * k;
+                    processes.switch_time += rounds * k * slice_cost;
+                }
+            }
+        }else if(ready_queue.size() != 1){
+            ready_set_changed = false; // with warmup, alternating slices differ in cost; stay on the slow path
+        }
+
+        int proc = ready_queue.front();
+        ready_queue.pop_front();
+        current_time += switches.dispatch(0, proc, static_cast<int>(current_time));
+        if(firstDispatch(processes, proc)) start_time[proc] = static_cast<int>(current_time);
+        int slice = min(time_quantum, remaining_time[proc]);
+        current_time += slice;
+        remaining_time[proc] -= slice;
+        ++processes.events;
+
+        admit(current_time); // arrivals at the end of the slice queue up ahead of the preempted process
+        if(remaining_time[proc] == 0){
+            processes.complete(proc, static_cast<int>(current_time));
+            total_execution_time += processes.burst_time[proc];
+            ready_set_changed = true;
+        }else{
+            switches.leave(0, proc, static_cast<int>(current_time));
+            ready_queue.push_back(proc);
+        }
+    }
+
+    return total_execution_time;
+}
+
+// Event-driven simulation of options.cores CPUs, each with its own ready queue. Arrivals are queued on a core
+// picked by options.placement; a core whose queue runs dry may steal (options.steal), and a process preempted by
+// RR goes back on the queue of the core it ran on. Each core pays its own context switches, and a process's cache
+// only stays warm on the core it last ran on. With one core this is the same schedule as simulatePolicy().
+template<class EventQueue>
+long long simulateMultiCore(ProcessTable& processes, int time_quantum, bool isRR, const SimulationOptions& options, MultiCoreStats& stats){
+    const int cores = options.cores;
+    EventQueue event_queue;
+    vector<deque<int>> ready_queues(cores); // per-core ready queues of dense process indices
+    vector<int> running(cores, NO_PROCESS); // process on each core
+    vector<int> last_core(processes.size(), -1); // core each process last ran on
+    int next_placement = 0;
+    size_t waiting = 0; // in all the ready queues, only kept up with stats
+    long long total_execution_time = 0;
+
+    processes.resetRunState();
+    vector<int>& remaining_time = processes.remaining_time;
+    vector<int>& start_time = processes.start_time;
+    const IntColumn& burst_time = processes.burst_time;
+    stats = MultiCoreStats();
+    stats.busy_time.assign(cores, 0);
+    stats.dispatches.assign(cores, 0);
+    stats.migrations.assign(cores, 0);
+    SwitchCostTracker switches(options.switch_cost, processes, cores);
+
+    auto dispatch = [&](int core, int proc, int now){
+        running[core] = proc;
+        ++stats.dispatches[core];
+        if(last_core[proc] >= 0 && last_core[proc] != core) ++stats.migrations[core];
+        last_core[proc] = core;
+        int begin = now + switches.dispatch(core, proc, now);
+        TRACE_EVENT(processes.trace, TraceKind::DISPATCH, now, proc, begin - now, core);
+        if(firstDispatch(processes, proc)) start_time[proc] = begin;
+        int slice = isRR ? min(time_quantum, remaining_time[proc]) : burst_time[proc];
+        stats.busy_time[core] += slice;
+        event_queue.push(Event(begin + slice, isRR ? EventType::TIME_SLICE : EventType::COMPLETION, proc));
+    };
+
+    // the next process for core: the front of its own queue, else the newest waiting process of the longest queue
+    auto takeNext = [&](int core){
+        if(!ready_queues[core].empty()){
+            int proc = ready_queues[core].front();
+            ready_queues[core].pop_front();
+            if(processes.stats) --waiting;
+            return proc;
+        }
+        if(options.steal == StealPolicy::NONE) return NO_PROCESS;
+        int victim = NO_PROCESS;
+        for(int c = 0; c < cores; ++c){
+            if(!ready_queues[c].empty() && (victim == NO_PROCESS || ready_queues[c].size() > ready_queues[victim].size())) victim = c;
+        }
+        if(victim == NO_PROCESS) return NO_PROCESS;
+        int proc = ready_queues[victim].back();
+        ready_queues[victim].pop_back();
+        if(processes.stats) --waiting;
+        ++stats.steals;
+        return proc;
+    };
+
+    vector<int> arrivals = arrivalOrder(processes);
+    size_t next_arrival = 0;
+    const IntColumn& arrival_time = processes.arrival_time;
+
+    while(next_arrival < arrivals.size() || !event_queue.empty()){
+        Event event(0, EventType::ARRIVAL, NO_PROCESS);
+        if(next_arrival < arrivals.size() && (event_queue.empty() || arrival_time[arrivals[next_arrival]] <= event_queue.top().event_time)){
+            int next = arrivals[next_arrival++];
+            event = Event(arrival_time[next], EventType::ARRIVAL, next);
+            if(processes.stats) processes.stats->sample(EventType::ARRIVAL, event_queue.size(), waiting);
+        }else{
+            event = event_queue.top();
+            if(processes.stats) processes.stats->sample(event.type, event_queue.size(), waiting);
+            event_queue.pop();
+        }
+        ++processes.events;
+        int current_time = event.event_time;
+        int proc = event.process;
+
+        if(event.type == EventType::ARRIVAL){
+            int target = 0;
+            if(options.placement == CorePlacement::ROUND_ROBIN){
+                target = next_placement;
+                next_placement = (next_placement + 1) % cores;
+            }else{
+                auto load = [&](int c){ return ready_queues[c].size() + (running[c] != NO_PROCESS ? 1 : 0); };
+                for(int c = 1; c < cores; ++c){
+                    if(load(c) < load(target)) target = c;
+                }
+            }
+
+            if(running[target] == NO_PROCESS){
+                dispatch(target, proc, current_time);
+            }else{
+                ready_queues[target].push_back(proc);
+                if(processes.stats) ++waiting;
+                // an idle core picks the new work up straight away instead of waiting for its next event
+                if(options.steal != StealPolicy::NONE){
+                    for(int c = 0; c < cores; ++c){
+                        if(running[c] != NO_PROCESS) continue;
+                        int next = takeNext(c);
+                        if(next != NO_PROCESS) dispatch(c, next, current_time);
+                        break;
+                    }
+                }
+            }
+            continue;
+        }
+
+        // COMPLETION or TIME_SLICE: the slice of proc on its core has ended
+        int core = last_core[proc];
+        if(running[core] != proc) continue;
+        int slice = isRR ? min(time_quantum, remaining_time[proc]) : remaining_time[proc];
+        remaining_time[proc] -= slice;
+        TRACE_EVENT(processes.trace, remaining_time[proc] == 0 ? TraceKind::COMPLETE : TraceKind::TIMER, current_time, proc, slice, core);
+        if(remaining_time[proc] == 0){
+            processes.complete(proc, current_time);
+            total_execution_time += burst_time[proc];
+        }else{
+            switches.leave(core, proc, current_time);
+            ready_queues[core].push_back(proc); // preempted, back on its own core's queue
+            if(processes.stats) ++waiting;
+        }
+        running[core] = NO_PROCESS;
+
+        int next = takeNext(core);
+        if(next != NO_PROCESS) dispatch(core, next, current_time);
+    }
+
+    return total_execution_time;
+}
+
+template<class EventQueue>
+long long simulateMultiCoreWith(ProcessTable& processes, int time_quantum, SchedulingPolicy policy, const SimulationOptions& options, MultiCoreStats* core_stats){
+    MultiCoreStats unused;
+    return simulateMultiCore<EventQueue>(processes, time_quantum, policy == SchedulingPolicy::RR, options, core_stats ? *core_stats : unused);
+}
+
+// run both RR engines on the same workload and report the first process they disagree on
+bool verifyRoundRobinEngines(const ProcessTable& processes, int time_quantum, const SimulationOptions& options, ostream& info){
+    ProcessTable stepped = processes, skipped = processes;
+    long long stepped_total = policySimulator(SchedulingPolicy::RR, options.queue_kind)(stepped, time_quantum, options);
+    long long skipped_total = simulateRoundRobinFastForward(skipped, time_quantum, options.switch_cost);
+
+    for(size_t i = 0; i < processes.size(); ++i){
+        if(stepped.start_time[i] != skipped.start_time[i] || stepped.end_time[i] != skipped.end_time[i]){
+            info << "RR engines differ on process " << processes.p_id[i] << ": start " << stepped.start_time[i] << " vs "
+                 << skipped.start_time[i] << ", end " << stepped.end_time[i] << " vs " << skipped.end_time[i] << "\n";
+            return false;
+        }
+    }
+    if(stepped_total != skipped_total){
+        info << "RR engines differ on total execution time: " << stepped_total << " vs " << skipped_total << "\n";
+        return false;
+    }
+    if(stepped.switches != skipped.switches || stepped.switch_time != skipped.switch_time){
+        info << "RR engines differ on context switches: " << stepped.switches << " (" << stepped.switch_time << " time units) vs "
+             << skipped.switches << " (" << skipped.switch_time << " time units)\n";
+        return false;
+    }
+    info << "RR engines match on all " << processes.size() << " processes\n";
+    return true;
+}
+
+// run one simulation on the engine and event queue picked by options. Returns the total CPU execution time.
+// Passing core_stats runs the multi-CPU engine (even for one core) and fills in its per-core counters.
+long long simulateProcesses(ProcessTable& processes,int time_quantum,SchedulingPolicy policy,const SimulationOptions& options,MultiCoreStats* core_stats){
+    if(options.cores > 1 || core_stats){
+        return options.queue_kind == EventQueueKind::CALENDAR
+            ? simulateMultiCoreWith<CalendarEventQueue>(processes, time_quantum, policy, options, core_stats)
+            : simulateMultiCoreWith<HeapEventQueue>(processes, time_quantum, policy, options, core_stats);
+    }
+    // the fast-forward engine only knows single CPU bursts and skips whole rounds; processes with I/O and runs
+    // recording their timeline or stats take the event-driven one
+    if(policy == SchedulingPolicy::RR && options.rr_fast_forward && processes.io.empty() && !processes.trace && !processes.stats){
+        return simulateRoundRobinFastForward(processes, time_quantum, options.switch_cost);
+    }
+    return policySimulator(policy, options.queue_kind)(processes, time_quantum, options);
+}
+
+// per-core utilization and migration counts of a multi-CPU run
+void displayCoreStats(long long makespan, const MultiCoreStats& stats, ostream& out){
+    long long total_migrations = 0;
+    streamsize precision = out.precision();
+    out << "Core  Busy time  Utilization  Dispatches  Migrations in\n";
+    for(size_t c = 0; c < stats.busy_time.size(); ++c){
+        float utilization = makespan > 0 ? 100.0f * stats.busy_time[c] / makespan : 0.0f;
+        out << setw(4) << c << setw(11) << stats.busy_time[c] << setw(12) << fixed << setprecision(2) << utilization << "%"
+            << setw(12) << stats.dispatches[c] << setw(15) << stats.migrations[c] << "\n";
+        out.unsetf(ios::floatfield);
+        out.precision(precision);
+        total_migrations += stats.migrations[c];
+    }
+    out << "Cross-core migrations: " << total_migrations << ", steals: " << stats.steals << "\n\n";
+}
+
+bool writeChromeTrace(const ExecutionTrace& trace, const ProcessTable& processes, const string& title, const string& filename){
+    FILE* file = fopen(filename.c_str(), "wb");
+    if(!file) return false;
+    {
+        OutputBuffer out(1 << 20, file);
+        out << "{\"otherData\":{\"timeUnit\":\"1 simulated time unit = 1 us\",\"recorded\":"
+            << static_cast<unsigned long long>(trace.recorded()) << ",\"dropped\":" << static_cast<unsigned long long>(trace.dropped())
+            << "},\n\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"" << title << "\"}}";
+
+        // a slice is a DISPATCH and the record that ends it; a ring that wrapped may have lost the dispatch of the
+        // first slices on each core, which then show without their context switch
+        static const char* const END_NAMES[] = {"dispatch", "preempt", "timer", "block", "complete"};
+        vector<TraceRecord> dispatched; // the open DISPATCH of each core, for process NO_PROCESS when there is none
+        trace.forEach([&](const TraceRecord& record){
+            if(record.core >= dispatched.size()){
+                for(int core = static_cast<int>(dispatched.size()); core <= record.core; ++core){
+                    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << core
+                        << ",\"args\":{\"name\":\"CPU " << core << "\"}}";
+                }
+                dispatched.resize(record.core + 1, TraceRecord{0, NO_PROCESS, 0, 0, TraceKind::DISPATCH, 0});
+            }
+            TraceRecord& open = dispatched[record.core];
+            if(record.kind == TraceKind::DISPATCH){
+                open = record;
+                return;
+            }
+            int run_start = record.time - record.value;
+            if(open.process == record.process && open.value > 0 && run_start > open.time){
+                // cut short when the process was preempted before the switch was over
+                out << ",\n{\"name\":\"switch\",\"cat\":\"switch\",\"ph\":\"X\",\"pid\":1,\"tid\":" << record.core
+                    << ",\"ts\":" << open.time << ",\"dur\":" << min(open.value, run_start - open.time) << "}";
+            }
+            open.process = NO_PROCESS;
+            if(record.value == 0) return;
+            const char* end = END_NAMES[static_cast<int>(record.kind)];
+            out << ",\n{\"name\":\"P" << processes.p_id[record.process] << "\",\"cat\":\"" << end
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << record.core << ",\"ts\":" << run_start
+                << ",\"dur\":" << record.value << ",\"args\":{\"id\":" << processes.p_id[record.process]
+                << ",\"end\":\"" << end << "\"}}";
+        });
+        out << "\n]}\n";
+    }
+    bool written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
+
+uint64_t cycleCounter(){
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+void displayStats(const SimulatorStats& stats, ostream& out){
+    long long events = max(1LL, stats.eventCount());
+    streamsize precision = out.precision();
+    out << "Simulator stats\n";
+    out << "Event          Count  Share\n";
+    out << fixed << setprecision(1);
+    for(int type = 0; type < EVENT_TYPE_COUNT; ++type){
+        out << left << setw(11) << EVENT_TYPE_NAMES[type] << right << setw(10) << stats.events[type] << setw(6)
+            << 100.0 * stats.events[type] / events << "%\n";
+    }
+    out << setprecision(2);
+    out << "Preempted slices: " << stats.preemptions << "\n";
+    out << "Event queue depth: max " << stats.max_event_queue << ", mean " << static_cast<double>(stats.total_event_queue) / events << "\n";
+    out << "Ready queue length: max " << stats.max_ready << ", mean " << static_cast<double>(stats.total_ready) / events << "\n";
+    out << "Ready length      Events  Share\n";
+    out << setprecision(1);
+    for(int bucket = 0; bucket < SimulatorStats::LENGTH_BUCKETS; ++bucket){
+        if(stats.ready_lengths[bucket] == 0) continue;
+        long long low = bucket ? 1LL << (bucket - 1) : 0, high = bucket ? (1LL << bucket) - 1 : 0;
+        string lengths = low == high ? to_string(low) : to_string(low) + "-" + to_string(high);
+        out << setw(12) << lengths << setw(12) << stats.ready_lengths[bucket] << setw(6)
+            << 100.0 * stats.ready_lengths[bucket] / events << "%\n";
+    }
+    out << "Phase                   Seconds          Cycles\n";
+    out << setprecision(6);
+    for(const PhaseTiming& phase : stats.phases){
+        out << left << setw(18) << phase.name << right << setw(13) << phase.seconds << setw(16);
+        if(phase.cycles) out << phase.cycles << "\n";
+        else out << "-" << "\n";
+    }
+    out.unsetf(ios::floatfield);
+    out.precision(precision);
+}
+
+// how busy the CPU and every I/O device were over a run with I/O, and how much of the time they overlapped
+void displayIoStats(long long makespan, const ProcessTable& processes, ostream& out){
+    streamsize precision = out.precision();
+    auto percent = [&](long long busy){ return makespan > 0 ? 100.0f * busy / makespan : 0.0f; };
+    out << "Resource  Busy time  Utilization\n";
+    out << setw(8) << "CPU" << setw(11) << processes.cpu_busy_time << setw(12) << fixed << setprecision(2)
+        << percent(processes.cpu_busy_time) << "%\n";
+    for(size_t d = 0; d < processes.device_busy_time.size(); ++d){
+        out << setw(8) << ("IO" + to_string(d)) << setw(11) << processes.device_busy_time[d] << setw(12)
+            << percent(processes.device_busy_time[d]) << "%\n";
+    }
+    out << "CPU busy during I/O: " << processes.overlap_time << " time units (" << percent(processes.overlap_time) << "%)\n\n";
+    out.unsetf(ios::floatfield);
+    out.precision(precision);
+}
+
+// summary of a run from the streaming metrics alone, for runs that kept no per-process records
+void displaySummary(const StreamingMetrics& metrics, long long total_execution_time, long long total_switch_time, OutputFormat format){
+    double cpu_efficiency = 100.0 * total_execution_time / max(1LL, total_execution_time + total_switch_time);
+    OutputBuffer out;
+    if(format != OutputFormat::HUMAN){
+        out.setPrecision(0);
+        writeSummaryRecord(out, format, RunSummary{metrics.completed, metrics.makespan,
+                                                   static_cast<float>(metrics.mean(metrics.total_tat)),
+                                                   static_cast<float>(metrics.mean(metrics.total_wt)),
+                                                   static_cast<float>(metrics.mean(metrics.total_rt)),
+                                                   static_cast<float>(cpu_efficiency), &metrics});
+        return;
+    }
+    out << "Processes completed: " << metrics.completed << "\n";
+    out << "Total Time required is " << metrics.makespan << " time units\n";
+    out << "Average Turn Around Time: " << metrics.mean(metrics.total_tat) << " time units\n";
+    out << "Average Waiting Time: " << metrics.mean(metrics.total_wt) << " time units\n";
+    out << "Average Response Time: " << metrics.mean(metrics.total_rt) << " time units\n";
+    out << "CPU Efficiency: " << cpu_efficiency << "%\n";
+    displayPercentiles(out, metrics);
+}
+
+// why the engines can't run this combination, or nullptr when they can
+const char* unsupportedRun(const ProcessTable& processes, SchedulingPolicy policy, const SimulationOptions& options){
+    if(!processes.io.empty() && (options.cores > 1 || (policy == SchedulingPolicy::RR && options.verify_rr))){
+        return "processes with I/O are only simulated on one CPU, without --cores or --verify-rr";
+    }
+    if(options.cores > 1 && policy != SchedulingPolicy::FCFS && policy != SchedulingPolicy::RR){
+        return "--cores only supports FCFS and RR";
+    }
+    return nullptr;
+}
+
+string invalidRun(const ProcessTable& processes, SchedulingPolicy policy, int time_quantum, const SimulationOptions& options){
+    if(processes.empty()) return "no processes";
+    if(policy == SchedulingPolicy::RR && time_quantum <= 0) return "RR needs a positive time quantum";
+    for(size_t i = 0; i < processes.size(); ++i){
+        if(processes.arrival_time[i] < 0 || processes.burst_time[i] <= 0){
+            return "process " + to_string(processes.p_id[i]) + " needs arrival >= 0 and burst > 0";
+        }
+    }
+    const char* problem = unsupportedRun(processes, policy, options);
+    return problem ? problem : "";
+}
+
+// Main function for running the CPU scheduling simulation.
+bool runSimulation(ProcessTable& processes,int time_quantum,SchedulingPolicy policy,const SimulationOptions& options){
+    if(const char* problem = unsupportedRun(processes, policy, options)){
+        cout << "Error: " << problem << "\n";
+        return false;
+    }
+    if(policy == SchedulingPolicy::RR && options.verify_rr && !verifyRoundRobinEngines(processes, time_quantum, options, infoStream(options))){
+        return false;
+    }
+
+    MultiCoreStats core_stats;
+    StreamingMetrics metrics;
+    bool multi_core = options.cores > 1;
+    processes.metrics = &metrics;
+    processes.keep_records = !options.summary_only;
+    unique_ptr<ExecutionTrace> trace;
+    if(!options.timeline.empty()){
+        trace = make_unique<ExecutionTrace>(options.timeline_capacity);
+        processes.trace = trace.get();
+    }
+    long long total_execution_time = 0;
+    timePhase(processes.stats, "simulateProcesses", [&]{
+        total_execution_time = simulateProcesses(processes, time_quantum, policy, options, multi_core ? &core_stats : nullptr);
+    });
+    long long total_switch_time = processes.switch_time; // simulated, so efficiency is busy vs switching time
+    processes.trace = nullptr;
+
+    if(trace){
+        string title = string(policyName(policy)) + (policy == SchedulingPolicy::RR ? " q=" + to_string(time_quantum) : "");
+        bool written = false;
+        timePhase(processes.stats, "writeChromeTrace", [&]{ written = writeChromeTrace(*trace, processes, title, options.timeline); });
+        if(!written){
+            cout << "Error: can't write " << options.timeline << "\n";
+            processes.metrics = nullptr; // metrics is about to go, don't leave the caller's table pointing at it
+            return false;
+        }
+        infoStream(options) << "Timeline: " << trace->recorded() - trace->dropped() << " records written to "
+                            << options.timeline << " (" << trace->dropped() << " older ones dropped)\n";
+    }
+
+    //display simulation results
+    if(multi_core) displayCoreStats(metrics.makespan, core_stats, infoStream(options));
+    if(!processes.io.empty()) displayIoStats(metrics.makespan, processes, infoStream(options));
+    if(options.summary_only){
+        timePhase(processes.stats, "displaySummary", [&]{ displaySummary(metrics, total_execution_time, total_switch_time, options.format); });
+    }else{
+        float avg_rt, avg_tat, avg_wt, cpu_efficiency;
+        timePhase(processes.stats, "calculateMetrics", [&]{
+            calculateMetrics(processes, avg_rt, avg_tat, avg_wt, cpu_efficiency, total_execution_time, total_switch_time);
+        });
+        timePhase(processes.stats, "displayResults", [&]{ displayResults(processes, avg_rt, avg_tat, avg_wt, cpu_efficiency, options.format); });
+    }
+    if(processes.stats) displayStats(*processes.stats, infoStream(options));
+    processes.metrics = nullptr;
+    return true;
+}
+
+// one (quantum, switch time) cell of a parameter sweep
+struct SweepResult{
+    int time_quantum, switch_time;
+    long long total_time;
+    double avg_tat, avg_wt, avg_rt, cpu_efficiency;
+    long long p99_tat;
+};
+
+// Run RR over every (quantum, switch time) pair on one shared workload and print a single results table.
+void runSweep(const Workload& workload, const vector<int>& quanta, const vector<int>& switch_times, const SimulationOptions& options){
+    vector<SweepResult> results(quanta.size() * switch_times.size());
+    WorkStealingPool pool;
+
+    auto start = chrono::steady_clock::now();
+    pool.run(results.size(), [&](size_t cell){
+        SweepResult& result = results[cell];
+        result.time_quantum = quanta[cell / switch_times.size()];
+        result.switch_time = switch_times[cell % switch_times.size()];
+
+        ProcessTable processes(workload); // private run state, shared input columns
+        StreamingMetrics metrics;
+        processes.metrics = &metrics;
+        processes.keep_records = false; // only the summary is reported
+        SimulationOptions cell_options = options;
+        cell_options.switch_cost.fixed = result.switch_time; // any warmup penalty from the command line stays
+        long long total_execution_time = simulateProcesses(processes, result.time_quantum, SchedulingPolicy::RR, cell_options);
+        long long total_switch_time = processes.switch_time;
+        result.total_time = metrics.makespan;
+        result.avg_tat = metrics.mean(metrics.total_tat);
+        result.avg_wt = metrics.mean(metrics.total_wt);
+        result.avg_rt = metrics.mean(metrics.total_rt);
+        result.p99_tat = metrics.turnaround.percentile(99);
+        result.cpu_efficiency = 100.0 * total_execution_time / max(1LL, total_execution_time + total_switch_time);
+    });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << setw(8) << "quantum" << setw(8) << "switch" << setw(12) << "total time" << setw(12) << "avg TAT"
+         << setw(12) << "p99 TAT" << setw(12) << "avg WT" << setw(12) << "avg RT" << setw(10) << "CPU eff%" << "\n";
+    cout << fixed << setprecision(2);
+    for(const auto& result : results){
+        cout << setw(8) << result.time_quantum << setw(8) << result.switch_time << setw(12) << result.total_time
+             << setw(12) << result.avg_tat << setw(12) << result.p99_tat << setw(12) << result.avg_wt << setw(12) << result.avg_rt
+             << setw(10) << result.cpu_efficiency << "\n";
+    }
+    cout << results.size() << " runs of " << workload.size() << " processes on " << pool.size() << " threads in "
+         << setprecision(3) << seconds << " s\n";
+    cout.unsetf(ios::floatfield);
+}
+
+// one run of a batch, as it came out
+struct BatchResult{
+    StreamingMetrics metrics;
+    long long total_execution_time = 0, switch_time = 0, events = 0;
+    double seconds = 0;
+};
+
+bool runBatch(const Workload& workload, const vector<BatchRun>& runs, const SimulationOptions& options, unsigned threads, string& error){
+    ProcessTable input(workload);
+    for(const BatchRun& run : runs){
+        if(const char* problem = unsupportedRun(input, run.policy, options)){
+            error = run.spec + ": " + problem;
+            return false;
+        }
+    }
+
+    vector<BatchResult> results(runs.size());
+    WorkStealingPool pool(threads ? threads : thread::hardware_concurrency());
+    auto start = chrono::steady_clock::now();
+    pool.run(runs.size(), [&](size_t r){
+        BatchResult& result = results[r];
+        auto run_start = chrono::steady_clock::now();
+        ProcessTable processes(workload); // private run state, shared input columns
+        processes.metrics = &result.metrics;
+        processes.keep_records = false; // only the summary is reported
+        result.total_execution_time = simulateProcesses(processes, runs[r].time_quantum, runs[r].policy, options);
+        result.switch_time = processes.switch_time;
+        result.events = processes.events;
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - run_start).count();
+    });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    size_t width = 8;
+    for(const BatchRun& run : runs) width = max(width, run.spec.size() + 2);
+    cout << left << setw(width) << "policy" << right << setw(11) << "completed" << setw(12) << "total time"
+         << setw(12) << "avg TAT" << setw(10) << "p99 TAT" << setw(12) << "avg WT" << setw(12) << "avg RT"
+         << setw(10) << "CPU eff%" << setw(12) << "events" << setw(10) << "seconds" << "\n";
+    for(size_t r = 0; r < runs.size(); ++r){
+        const BatchResult& result = results[r];
+        const StreamingMetrics& metrics = result.metrics;
+        double efficiency = 100.0 * result.total_execution_time / max(1LL, result.total_execution_time + result.switch_time);
+        cout << left << setw(width) << runs[r].spec << right << setw(11) << metrics.completed
+             << setw(12) << metrics.makespan << fixed << setprecision(2) << setw(12) << metrics.mean(metrics.total_tat)
+             << setw(10) << metrics.turnaround.percentile(99) << setw(12) << metrics.mean(metrics.total_wt)
+             << setw(12) << metrics.mean(metrics.total_rt) << setw(10) << efficiency << setw(12) << result.events
+             << setprecision(3) << setw(10) << result.seconds << "\n";
+        cout.unsetf(ios::floatfield);
+    }
+    cout << runs.size() << " runs of " << workload.size() << " processes on " << pool.size() << " threads in "
+         << fixed << setprecision(3) << seconds << " s\n";
+    cout.unsetf(ios::floatfield);
+    return true;
+}
+
+// parse a sweep axis such as "5,10,20" or "1:100:5" (start:end:step, end inclusive), or a mix of both
+bool parseSweepValues(const string& spec, vector<int>& values){
+    stringstream items(spec);
+    string item;
+    while(getline(items, item, ',')){
+        int start, end, step = 1;
+        char sep1, sep2;
+        istringstream range(item);
+        if(!(range >> start)) return false;
+        if(range >> sep1){
+            if(sep1 != ':' || !(range >> end)) return false;
+            if(range >> sep2 && (sep2 != ':' || !(range >> step) || step <= 0)) return false;
+            for(int v = start; v <= end; v += step) values.push_back(v);
+        }else{
+            values.push_back(start);
+        }
+    }
+    return !values.empty();
+}
+
+bool parsePolicySpec(const string& spec, int default_quantum, SchedulingPolicy& policy, int& time_quantum){
+    size_t colon = spec.find(':');
+    string name = spec.substr(0, colon);
+    for(char& c : name) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    const char* const* found = find(begin(POLICY_NAMES), end(POLICY_NAMES), name);
+    if(found == end(POLICY_NAMES)) return false;
+    policy = static_cast<SchedulingPolicy>(found - begin(POLICY_NAMES));
+    time_quantum = default_quantum;
+    if(colon != string::npos){
+        const char* first = spec.c_str() + colon + 1;
+        const char* last = spec.c_str() + spec.size();
+        auto [parsed, ec] = from_chars(first, last, time_quantum);
+        if(ec != errc() || parsed != last || first == last) return false;
+    }
+    return time_quantum > 0 || policy != SchedulingPolicy::RR;
+}
+
+bool parseBatchRuns(const string& spec, int default_quantum, const Workload& workload, const SimulationOptions& options,
+                    vector<BatchRun>& runs, string& error){
+    runs.clear();
+    if(spec == "all"){
+        ProcessTable input(workload);
+        for(int p = 0; p < POLICY_COUNT; ++p){
+            SchedulingPolicy policy = static_cast<SchedulingPolicy>(p);
+            if(unsupportedRun(input, policy, options)) continue;
+            bool rr = policy == SchedulingPolicy::RR;
+            runs.push_back(BatchRun{string(policyName(policy)) + (rr ? ":" + to_string(default_quantum) : ""), policy, default_quantum});
+        }
+        return true;
+    }
+    stringstream items(spec);
+    string item;
+    while(getline(items, item, ',')){
+        BatchRun run;
+        run.spec = item;
+        if(!parsePolicySpec(item, default_quantum, run.policy, run.time_quantum)){
+            error = "a batch run looks like RR:4 or CFS, not \"" + item + "\"";
+            return false;
+        }
+        runs.push_back(run);
+    }
+    if(runs.empty()) error = "no runs in \"" + spec + "\"";
+    return !runs.empty();
+}
+
+// An I/O step needs a device in range, no negative I/O time and a CPU burst after it, and the process's total CPU
+// time (burst_total, which it adds to) has to stay within an int.
+bool validIoStep(const IoStep& step, int& burst_total){
+    if(step.device < SLEEP_DEVICE || step.device >= MAX_IO_DEVICES || step.io_time < 0 || step.cpu_time <= 0) return false;
+    if(burst_total > numeric_limits<int>::max() - step.cpu_time) return false;
+    burst_total += step.cpu_time;
+    return true;
+}
+
+// read input.txt with iostreams, one process per line (kept as the reference reader for --parse-bench)
+Workload readProcessesStream(const string& filename, int num_processes){
+    ifstream infile(filename); // Open input.txt
+    Workload processes; // Table to store processes.
+    int id, arrival, burst;
+    string first_line;
+
+    // input.txt starts with a count header line, skip it if the first line only holds one number
+    streampos body_start = infile.tellg();
+    if(getline(infile, first_line)){
+        istringstream header(first_line);
+        int count, extra;
+        if(!(header >> count) || (header >> extra)){
+            infile.clear();
+            infile.seekg(body_start); // not a header, re-read the first line as a process
+        }
+    }
+
+    //read each process
+    vector<IoStep> steps;
+    for(int i = 0; num_processes < 0 || i < num_processes; ++i){
+        if(!(infile >> id >> arrival >> burst)){
+            break;
+        }
+        // an optional fourth number on the same line is the nice value
+        int nice = 0;
+        while(infile.peek() == ' ' || infile.peek() == '\t') infile.get();
+        if(infile.peek() != '\n' && infile.peek() != '\r' && infile.peek() != EOF && infile.peek() != 'i' && infile.peek() != 's' && !(infile >> nice)){
+            break;
+        }
+        // then any number of "io <device> <io time> <cpu burst>" and "sleep <time> <cpu burst>" steps
+        steps.clear();
+        int total = burst;
+        bool ok = true;
+        while(true){
+            while(infile.peek() == ' ' || infile.peek() == '\t') infile.get();
+            if(infile.peek() != 'i' && infile.peek() != 's') break;
+            string word;
+            IoStep step{SLEEP_DEVICE, 0, 0};
+            ok = infile >> word && (word == "sleep" || (word == "io" && infile >> step.device)) &&
+                 infile >> step.io_time >> step.cpu_time && validIoStep(step, total) && (word == "sleep") == (step.device == SLEEP_DEVICE);
+            if(!ok) break;
+            steps.push_back(step);
+        }
+        if(!ok || arrival < 0 || burst <= 0){
+            break;
+        }
+        processes.add(id, arrival, burst, nice);
+        for(const IoStep& step : steps) processes.addIoStep(step);
+    }
+
+    return processes; //return list of process
+}
+
+inline bool isBlank(char c){
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Scan the next integer from [pos, end), skipping leading whitespace. Returns false at end of input or on a bad token.
+inline bool scanInt(const char*& pos, const char* end, int& value){
+    while(pos < end && isBlank(*pos)) ++pos;
+    if(pos == end) return false;
+    auto [ptr, ec] = from_chars(pos, end, value);
+    if(ec != errc() || (ptr < end && !isBlank(*ptr))) return false;
+    pos = ptr;
+    return true;
+}
+
+// the keyword word starting at pos
+inline bool scanKeyword(const char*& pos, const char* end, const char* word){
+    size_t length = strlen(word);
+    if(static_cast<size_t>(end - pos) < length || memcmp(pos, word, length) != 0) return false;
+    if(pos + length < end && !isBlank(pos[length])) return false;
+    pos += length;
+    return true;
+}
+
+// Parse "id arrival burst [nice] [io <device> <io time> <burst> | sleep <time> <burst> ...]" records from
+// [pos, end) into out, stopping after limit records (limit < 0 means no limit) or at the first malformed record,
+// which includes one with a negative arrival or a burst that isn't positive.
+// The nice value and the I/O steps are optional and have to start on the same line as the burst. Returns where it
+// stopped: end once every record was read, the start of the malformed record otherwise (or of the first one past
+// limit).
+const char* parseProcessRecords(const char* pos, const char* end, int limit, Workload& out){
+    int id, arrival, burst;
+    vector<IoStep> steps;
+    while(limit < 0 || static_cast<int>(out.size()) < limit){
+        while(pos < end && isBlank(*pos)) ++pos;
+        if(pos == end) break;
+        const char* record = pos;
+        if(!scanInt(pos, end, id) || !scanInt(pos, end, arrival) || !scanInt(pos, end, burst)){
+            return record;
+        }
+        int nice = 0;
+        while(pos < end && (*pos == ' ' || *pos == '\t')) ++pos;
+        if(pos < end && *pos != '\n' && *pos != '\r' && *pos != 'i' && *pos != 's' && !scanInt(pos, end, nice)){
+            return record;
+        }
+        steps.clear();
+        int total = burst;
+        bool ok = true;
+        while(true){
+            while(pos < end && (*pos == ' ' || *pos == '\t')) ++pos;
+            if(pos == end || (*pos != 'i' && *pos != 's')) break;
+            IoStep step{SLEEP_DEVICE, 0, 0};
+            bool device = scanKeyword(pos, end, "io") && scanInt(pos, end, step.device) && step.device != SLEEP_DEVICE;
+            ok = (device || scanKeyword(pos, end, "sleep")) && scanInt(pos, end, step.io_time) &&
+                 scanInt(pos, end, step.cpu_time) && validIoStep(step, total);
+            if(!ok) break;
+            steps.push_back(step);
+        }
+        if(!ok || arrival < 0 || burst <= 0){ // as the daemon and the addon require
+            return record;
+        }
+        out.add(id, arrival, burst, nice);
+        for(const IoStep& step : steps) out.addIoStep(step);
+    }
+    return pos;
+}
+
+// Binary workload file, version 1: a fixed 64-byte header followed by the arrival[], burst[] and id[] columns
+// as int32 arrays, a nice[] column when any process has one, and the I/O steps when any process does I/O: a
+// uint64 step count, uint64 offsets[count + 1] (process i's steps are [offsets[i], offsets[i + 1])) and the
+// IoStep triples. Every column starts on an 8-byte boundary, so a mapped file is used as the process table
+// directly without copying or parsing. burst[] holds each process's total CPU time, as in a Workload.
+const char WORKLOAD_MAGIC[8] = {'P', 'P', 'W', 'O', 'R', 'K', 'L', 'D'};
+const uint32_t WORKLOAD_VERSION = 1;
+const uint32_t WORKLOAD_BYTE_ORDER = 0x01020304; // reads back differently on a host of the other endianness
+
+struct WorkloadFileHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t count; // number of processes
+    uint64_t arrival_offset, burst_offset, id_offset; // byte offsets of the columns from the start of the file
+    uint64_t nice_offset; // 0 when there is no nice column (every process is nice 0)
+    uint64_t io_offset; // 0 when no process does I/O
+};
+static_assert(sizeof(WorkloadFileHeader) == 64, "workload header layout is part of the file format");
+
+inline uint64_t alignTo8(uint64_t offset){ return (offset + 7) & ~uint64_t(7); }
+
+bool isBinaryWorkload(const MappedFile& file){
+    return file.size() >= sizeof(WORKLOAD_MAGIC) && memcmp(file.data(), WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC)) == 0;
+}
+
+// Find the I/O steps of a binary workload and check them the way the text readers check theirs, since the
+// engines trust them: offsets in order, every step valid and each process's steps leaving it a first burst.
+bool mapIoSteps(const MappedFile& file, const WorkloadFileHeader& header, const int* bursts, const uint64_t*& offsets,
+                const IoStep*& steps, string& error){
+    uint64_t offset = header.io_offset;
+    uint64_t step_count;
+    if(offset % 8 != 0 || offset < sizeof(header) || offset > file.size() || file.size() - offset < sizeof(step_count)){
+        error = "I/O steps outside the file";
+        return false;
+    }
+    memcpy(&step_count, file.data() + offset, sizeof(step_count));
+    uint64_t room = file.size() - offset - sizeof(step_count); // bytes left for the offsets and the steps
+    if(room / sizeof(uint64_t) < header.count + 1 || (room - (header.count + 1) * sizeof(uint64_t)) / sizeof(IoStep) < step_count){
+        error = "I/O steps outside the file";
+        return false;
+    }
+    offsets = reinterpret_cast<const uint64_t*>(file.data() + offset + sizeof(step_count));
+    steps = reinterpret_cast<const IoStep*>(offsets + header.count + 1);
+    if(offsets[0] != 0 || offsets[header.count] != step_count){
+        error = "bad I/O step offsets";
+        return false;
+    }
+    for(uint64_t i = 0; i < header.count; ++i){
+        if(offsets[i + 1] < offsets[i] || offsets[i + 1] > step_count){
+            error = "bad I/O step offsets";
+            return false;
+        }
+        int total = 0;
+        for(uint64_t s = offsets[i]; s < offsets[i + 1]; ++s){
+            if(!validIoStep(steps[s], total)){
+                error = "bad I/O step";
+                return false;
+            }
+        }
+        if(offsets[i + 1] > offsets[i] && bursts[i] - total <= 0){
+            error = "I/O steps longer than the process's CPU time";
+            return false;
+        }
+    }
+    return true;
+}
+
+// use the columns of a binary workload file in place; num_processes < 0 uses every process in the file
+bool mapBinaryWorkload(shared_ptr<const MappedFile> file, int num_processes, Workload& out, string& error){
+    if(file->size() < sizeof(WorkloadFileHeader)){
+        error = "truncated header";
+        return false;
+    }
+    WorkloadFileHeader header;
+    memcpy(&header, file->data(), sizeof(header));
+    if(header.version != WORKLOAD_VERSION){
+        error = "unsupported version " + to_string(header.version);
+        return false;
+    }
+    if(header.byte_order != WORKLOAD_BYTE_ORDER){
+        error = "written on a machine of the other byte order";
+        return false;
+    }
+    if(header.count > static_cast<uint64_t>(numeric_limits<int>::max())){
+        error = "too many processes";
+        return false;
+    }
+    vector<uint64_t> offsets{header.arrival_offset, header.burst_offset, header.id_offset};
+    if(header.nice_offset != 0) offsets.push_back(header.nice_offset);
+    for(uint64_t offset : offsets){
+        if(offset % 8 != 0 || offset < sizeof(header) || offset > file->size() || (file->size() - offset) / sizeof(int32_t) < header.count){
+            error = "column outside the file";
+            return false;
+        }
+    }
+
+    size_t count = num_processes < 0 ? header.count : min<size_t>(header.count, num_processes);
+    auto column = [&](uint64_t offset){ return reinterpret_cast<const int*>(file->data() + offset); };
+    const uint64_t* io_offsets = nullptr;
+    const IoStep* io_steps = nullptr;
+    if(header.io_offset != 0 && !mapIoSteps(*file, header, column(header.burst_offset), io_offsets, io_steps, error)){
+        return false;
+    }
+    out = Workload::mapped(file, column(header.id_offset), column(header.arrival_offset), column(header.burst_offset),
+                           header.nice_offset ? column(header.nice_offset) : nullptr, io_offsets, io_steps, count);
+    return true;
+}
+
+// write a workload in the binary format read by mapBinaryWorkload
+bool writeBinaryWorkload(const Workload& workload, const string& filename){
+    ofstream outfile(filename, ios::binary);
+    if(!outfile) return false;
+
+    uint64_t column_bytes = workload.size() * sizeof(int32_t);
+    WorkloadFileHeader header = {};
+    memcpy(header.magic, WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC));
+    header.version = WORKLOAD_VERSION;
+    header.byte_order = WORKLOAD_BYTE_ORDER;
+    header.count = workload.size();
+    header.arrival_offset = sizeof(header);
+    header.burst_offset = alignTo8(header.arrival_offset + column_bytes);
+    header.id_offset = alignTo8(header.burst_offset + column_bytes);
+    IntColumn nices = workload.niceColumn();
+    IoColumn io = workload.ioColumn();
+    uint64_t end = alignTo8(header.id_offset + column_bytes);
+    if(!nices.empty()){
+        header.nice_offset = end;
+        end = alignTo8(header.nice_offset + column_bytes);
+    }
+    if(!io.empty()) header.io_offset = end;
+    outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const char padding[8] = {};
+    for(IntColumn column : {workload.arrivalColumn(), workload.burstColumn(), workload.idColumn(), nices}){
+        if(column.empty()) continue;
+        outfile.write(reinterpret_cast<const char*>(column.data()), column_bytes);
+        outfile.write(padding, alignTo8(column_bytes) - column_bytes);
+    }
+    if(!io.empty()){
+        uint64_t step_count = io.totalSteps();
+        outfile.write(reinterpret_cast<const char*>(&step_count), sizeof(step_count));
+        for(size_t i = 0; i <= workload.size(); ++i){
+            uint64_t offset = i < workload.size() ? io.begin(i) - io.begin(0) : step_count;
+            outfile.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        }
+        outfile.write(reinterpret_cast<const char*>(io.begin(0)), step_count * sizeof(IoStep));
+    }
+    return static_cast<bool>(outfile);
+}
+
+// write a workload as input.txt-style text, count header first. Blocks of rows are formatted with to_chars on
+// every core and written out in order, so big workloads are bound by the disk rather than by formatting.
+bool writeTextWorkload(const Workload& workload, const string& filename){
+    FILE* out = filename == "-" ? stdout : fopen(filename.c_str(), "wb");
+    if(!out) return false;
+
+    const size_t ROWS_PER_BLOCK = 1 << 16;
+    const size_t MAX_ROW_CHARS = 4 * 12; // up to four ints with sign and separator
+    const size_t MAX_STEP_CHARS = 3 + 3 * 12; // " io" and three ints, or " sleep" and two
+    IntColumn ids = workload.idColumn(), arrivals = workload.arrivalColumn(), bursts = workload.burstColumn();
+    IntColumn nices = workload.niceColumn(); // written only when there is one
+    IoColumn io = workload.ioColumn();
+    size_t blocks = (workload.size() + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+    WorkStealingPool pool(blocks > 1 ? thread::hardware_concurrency() : 1);
+    vector<vector<char>> text(pool.size(), vector<char>(ROWS_PER_BLOCK * MAX_ROW_CHARS));
+    vector<size_t> used(pool.size());
+
+    string header = to_string(workload.size()) + "\n";
+    bool ok = fwrite(header.data(), 1, header.size(), out) == header.size();
+    // one round formats pool.size() consecutive blocks, one per buffer, then writes them in order
+    for(size_t first = 0; first < blocks && ok; first += pool.size()){
+        size_t round = min<size_t>(pool.size(), blocks - first);
+        pool.run(round, [&](size_t slot){
+            size_t begin = (first + slot) * ROWS_PER_BLOCK, end = min(workload.size(), begin + ROWS_PER_BLOCK);
+            if(!io.empty()){
+                size_t steps = io.begin(end - 1) + io.stepCount(end - 1) - io.begin(begin);
+                text[slot].resize(max(text[slot].size(), (end - begin) * MAX_ROW_CHARS + steps * MAX_STEP_CHARS));
+            }
+            char* pos = text[slot].data();
+            char* limit = pos + text[slot].size();
+            for(size_t i = begin; i < end; ++i){
+                size_t step_count = io.stepCount(i);
+                int first_burst = bursts[i];
+                for(size_t s = 0; s < step_count; ++s) first_burst -= io.begin(i)[s].cpu_time;
+                pos = to_chars(pos, limit, ids[i]).ptr;
+                *pos++ = ' ';
+                pos = to_chars(pos, limit, arrivals[i]).ptr;
+                *pos++ = ' ';
+                pos = to_chars(pos, limit, first_burst).ptr;
+                if(!nices.empty()){
+                    *pos++ = ' ';
+                    pos = to_chars(pos, limit, nices[i]).ptr;
+                }
+                for(size_t s = 0; s < step_count; ++s){
+                    const IoStep& step = io.begin(i)[s];
+                    if(step.device == SLEEP_DEVICE){
+                        pos = copy_n(" sleep ", 7, pos);
+                    }else{
+                        pos = copy_n(" io ", 4, pos);
+                        pos = to_chars(pos, limit, step.device).ptr;
+                        *pos++ = ' ';
+                    }
+                    pos = to_chars(pos, limit, step.io_time).ptr;
+                    *pos++ = ' ';
+                    pos = to_chars(pos, limit, step.cpu_time).ptr;
+                }
+                *pos++ = '\n';
+            }
+            used[slot] = pos - text[slot].data();
+        });
+        for(size_t slot = 0; slot < round && ok; ++slot){
+            ok = fwrite(text[slot].data(), 1, used[slot], out) == used[slot];
+        }
+    }
+    if(out == stdout) return fflush(out) == 0 && ok;
+    return fclose(out) == 0 && ok;
+}
+
+const size_t PARALLEL_PARSE_MIN_BYTES = 8 << 20; // below this, thread startup costs more than it saves
+
+// read input.txt: mmap the file and scan it with from_chars, split over threads by line chunks for big files.
+// Binary workload files are recognised by their magic and used straight from the mapping instead.
+// num_processes < 0 reads every process in the file. A malformed record fails the whole read (with the line it is
+// on reported) rather than cutting the workload short; a count header that doesn't match what was read is warned
+// about. Both go to stderr, so CSV or JSON on stdout stays clean.
+Workload readProcesses(const string& filename, int num_processes){
+    Workload processes; // Table to store processes.
+    auto mapping = make_shared<const MappedFile>(filename);
+    const MappedFile& file = *mapping;
+    if(!file.is_open() || file.size() == 0){
+        return processes;
+    }
+
+    if(isBinaryWorkload(file)){
+        string error;
+        if(!mapBinaryWorkload(mapping, num_processes, processes, error)){
+            cout << "Error: " << filename << " is not a valid workload file (" << error << ")\n";
+        }
+        return processes;
+    }
+
+    const char* pos = file.data();
+    const char* end = pos + file.size();
+
+    // input.txt starts with a count header line, skip it if the first line only holds one number
+    const char* line_end = static_cast<const char*>(memchr(pos, '\n', end - pos));
+    if(!line_end) line_end = end;
+    const char* cursor = pos;
+    int count, extra;
+    bool header = scanInt(cursor, line_end, count) && !scanInt(cursor, line_end, extra);
+    if(header){
+        pos = line_end;
+        if(count > 0) processes.reserve(num_processes < 0 ? count : min(count, num_processes));
+    }
+
+    // the malformed record at stopped, if the parse stopped before the end and short of num_processes
+    auto malformed = [&](const char* stopped, size_t parsed){
+        if(stopped == end || (num_processes >= 0 && parsed >= static_cast<size_t>(num_processes))) return false;
+        cerr << "Error: " << filename << " line " << count_if(file.data(), stopped, [](char c){ return c == '\n'; }) + 1
+             << " is not a valid process record (id, arrival >= 0, burst > 0, [nice], [io/sleep steps])\n";
+        return true;
+    };
+    // a header that promised another number of processes than the file holds
+    auto checkCount = [&]{
+        size_t expected = num_processes < 0 ? static_cast<size_t>(max(0, count)) : static_cast<size_t>(max(0, min(count, num_processes)));
+        if(header && processes.size() != expected){
+            cerr << "Warning: " << filename << " says it holds " << count << " processes, read " << processes.size() << "\n";
+        }
+    };
+
+    unsigned num_threads = max(1u, thread::hardware_concurrency());
+    if(num_processes >= 0 || num_threads == 1 || static_cast<size_t>(end - pos) < PARALLEL_PARSE_MIN_BYTES){
+        const char* stopped = parseProcessRecords(pos, end, num_processes, processes);
+        if(malformed(stopped, processes.size())) return Workload();
+        checkCount();
+        return processes;
+    }
+
+    // split the body into one chunk per thread, each ending on a line boundary
+    vector<const char*> bounds{pos};
+    size_t chunk = (end - pos) / num_threads;
+    for(unsigned t = 1; t < num_threads; ++t){
+        const char* split = max(bounds.back(), pos + t * chunk);
+        const char* nl = static_cast<const char*>(memchr(split, '\n', end - split));
+        bounds.push_back(nl ? nl + 1 : end);
+    }
+    bounds.push_back(end);
+
+    vector<Workload> parts(num_threads);
+    vector<const char*> stopped(num_threads);
+    vector<thread> workers;
+    for(unsigned t = 0; t < num_threads; ++t){
+        workers.emplace_back([&, t]{
+            parts[t].reserve((bounds[t + 1] - bounds[t]) / 8);
+            stopped[t] = parseProcessRecords(bounds[t], bounds[t + 1], -1, parts[t]);
+        });
+    }
+    for(auto& worker : workers) worker.join();
+
+    // the first chunk that stopped short has the first malformed record; nothing after it counts
+    for(unsigned t = 0; t < num_threads; ++t){
+        if(stopped[t] != bounds[t + 1]){
+            malformed(stopped[t], 0);
+            return Workload();
+        }
+    }
+
+    size_t total = 0;
+    for(const auto& part : parts) total += part.size();
+    processes.reserve(total);
+    for(const auto& part : parts){
+        processes.append(part);
+    }
+    checkCount();
+    return processes; //return list of process
+}
+
+// turn a text workload ("id arrival burst [nice] [io ...]" lines) into the binary workload format
+int convertWorkload(const string& input, const string& output){
+    Workload workload = readProcesses(input, -1);
+    if(workload.empty()){
+        cout << "Error: no processes read from " << input << "\n";
+        return 1;
+    }
+    if(!writeBinaryWorkload(workload, output)){
+        cout << "Error: cannot write " << output << "\n";
+        return 1;
+    }
+    cout << "Wrote " << workload.size() << " processes to " << output << "\n";
+    return 0;
+}
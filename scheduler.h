@@ -0,0 +1,1231 @@
+// Scheduling engine: workloads, the process table, event queues and the scheduling simulations, plus the readers
+// and reports built on them. main.cpp is the interactive front end and benchmark.cpp the benchmark harness.
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "indexed_heap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+// event types for the CPU scheduling simulation
+enum class EventType{
+    ARRIVAL,
+    COMPLETION, // the last CPU burst ran out
+    TIME_SLICE, // the timer fired mid-burst
+    BLOCK, // a CPU burst with I/O after it ran out: the process moves to its device
+    UNBLOCK // a device finished a process's I/O: it is ready for its next CPU burst
+};
+
+// Event class for managing simulation events.
+class Event{
+public:
+    int event_time; // time when the event occurs
+    EventType type; // type of event (arrival, completion, or time slice)
+    int process; // dense index of the process in the Workload/ProcessTable (not its p_id)
+
+    Event(int time, EventType et, int index) : event_time(time), type(et), process(index){}
+
+};
+
+// Event queues all provide push(event), top(), pop(), empty() and size(), so runSimulation can be instantiated
+// with any of them. Events are ordered by event time, and events with equal times come out in the order they
+// were pushed, so every queue produces the exact same simulation. push() returns a handle that stays valid until
+// the event is popped or cancelled: cancel(handle) drops a pending event and reschedule(handle, time) moves it
+// (returning its new handle), so a preempted slice leaves nothing stale behind in the queue. pending() lists the
+// events in the order they will come out, which pushing them again in that order into an empty queue recreates.
+enum class EventQueueKind{HEAP, CALENDAR};
+
+using EventHandle = int;
+
+// An event stamped with its push order, used to break ties between equal event times.
+struct QueuedEvent{
+    Event event;
+    uint64_t seq;
+
+    bool before(const QueuedEvent& other) const{
+        return event.event_time != other.event.event_time ? event.event_time < other.event.event_time : seq < other.seq;
+    }
+};
+
+// Indexed 4-ary heap event queue: O(log n) push, pop, cancel and reschedule. The heap holds just (time, push
+// order, handle) in 16 bytes, so the four children of a node share a cache line; the events themselves sit in a
+// side table indexed by handle, and handles are recycled.
+class HeapEventQueue{
+public:
+    EventHandle push(const Event& event){
+        EventHandle handle = newHandle(event);
+        heap.push(handle, keyOf(event.event_time));
+        return handle;
+    }
+
+    const Event& top() const{ return events[heap.top()]; }
+    void pop(){ free_handles.push_back(heap.pop()); }
+    bool empty() const{ return heap.empty(); }
+    size_t size() const{ return heap.size(); }
+
+    void cancel(EventHandle handle){
+        heap.erase(handle);
+        free_handles.push_back(handle);
+    }
+
+    // the moved event ties with others at its new time as if it had just been pushed
+    EventHandle reschedule(EventHandle handle, int time){
+        events[handle].event_time = time;
+        heap.update(handle, keyOf(time));
+        return handle;
+    }
+
+    std::vector<Event> pending() const{
+        std::vector<Event> in_order;
+        for(EventHandle handle : heap.itemsInOrder()) in_order.push_back(events[handle]);
+        return in_order;
+    }
+
+private:
+    // event time, then push order; the 64-bit push counter is split so the key packs into 12 bytes
+    struct Key{
+        int time;
+        uint32_t seq_high, seq_low;
+
+        bool operator<(const Key& other) const{
+            if(time != other.time) return time < other.time;
+            return seq_high != other.seq_high ? seq_high < other.seq_high : seq_low < other.seq_low;
+        }
+    };
+
+    IndexedDaryHeap<Key> heap;
+    std::vector<Event> events; // by handle
+    std::vector<EventHandle> free_handles;
+    uint64_t next_seq = 0;
+
+    Key keyOf(int time){
+        uint64_t seq = next_seq++;
+        return Key{time, static_cast<uint32_t>(seq >> 32), static_cast<uint32_t>(seq)};
+    }
+
+    EventHandle newHandle(const Event& event){
+        if(free_handles.empty()){
+            events.push_back(event);
+            return static_cast<EventHandle>(events.size() - 1);
+        }
+        EventHandle handle = free_handles.back();
+        free_handles.pop_back();
+        events[handle] = event;
+        return handle;
+    }
+};
+
+// Calendar queue (R. Brown, 1988): events are hashed by time into buckets that are each one "day" wide, and the
+// buckets together cover one "year". Dequeue walks the days from the last one served, so push and pop are
+// amortized O(1) as long as the day width matches the spacing of pending events. The bucket count doubles or
+// halves with the number of pending events, and the width is re-estimated from the earliest events each time.
+// Each bucket is a sorted linked list threaded through one node pool, so pushes and pops never allocate.
+class CalendarEventQueue{
+public:
+    CalendarEventQueue(){ buckets.resize(MIN_BUCKETS); }
+
+    EventHandle push(const Event& event){
+        int node = allocNode(QueuedEvent{event, next_seq++});
+        long long time = event.event_time;
+        // an event earlier than the day being served restarts the walk from its own day
+        if(count == 0 || time < bucket_top - width){
+            setCurrentDay(time);
+        }
+        link(buckets[bucketOf(time)], node);
+        located = false;
+        ++count;
+        if(count > 2 * buckets.size()) resize(2 * buckets.size());
+        return node; // nodes keep their index across resizes
+    }
+
+    const Event& top(){
+        locate();
+        return nodes[buckets[current].head].entry.event;
+    }
+
+    void pop(){
+        locate();
+        Bucket& bucket = buckets[current];
+        int node = bucket.head;
+        bucket.head = nodes[node].next;
+        if(bucket.head == NIL) bucket.tail = NIL;
+        nodes[node].next = free_list;
+        free_list = node;
+        --count;
+        located = false;
+        if(buckets.size() > MIN_BUCKETS && count < buckets.size() / 2) resize(buckets.size() / 2);
+    }
+
+    bool empty() const{ return count == 0; }
+    size_t size() const{ return count; }
+
+    // unlink the node from its day's list; buckets hold a handful of events, so the walk is O(1) on average
+    void cancel(EventHandle node){
+        Bucket& bucket = buckets[bucketOf(nodes[node].entry.event.event_time)];
+        int prev = NIL;
+        for(int n = bucket.head; n != node; n = nodes[n].next) prev = n;
+        int next = nodes[node].next;
+        if(prev == NIL) bucket.head = next;
+        else nodes[prev].next = next;
+        if(bucket.tail == node) bucket.tail = prev;
+        nodes[node].next = free_list;
+        free_list = node;
+        --count;
+        located = false;
+        if(buckets.size() > MIN_BUCKETS && count < buckets.size() / 2) resize(buckets.size() / 2);
+    }
+
+    EventHandle reschedule(EventHandle node, int time){
+        Event event = nodes[node].entry.event;
+        cancel(node);
+        event.event_time = time;
+        return push(event);
+    }
+
+    std::vector<Event> pending() const{
+        std::vector<const QueuedEvent*> entries;
+        for(const auto& bucket : buckets){
+            for(int node = bucket.head; node != NIL; node = nodes[node].next) entries.push_back(&nodes[node].entry);
+        }
+        sort(entries.begin(), entries.end(), [](const QueuedEvent* a, const QueuedEvent* b){ return a->before(*b); });
+        std::vector<Event> in_order;
+        for(const QueuedEvent* entry : entries) in_order.push_back(entry->event);
+        return in_order;
+    }
+
+private:
+    static const int NIL = -1;
+    static const size_t MIN_BUCKETS = 2;
+    static const size_t WIDTH_SAMPLE = 25;
+
+    struct Node{
+        QueuedEvent entry;
+        int next;
+    };
+
+    // events of one day across all years, sorted by (time, seq)
+    struct Bucket{
+        int head = NIL;
+        int tail = NIL;
+    };
+
+    std::vector<Node> nodes; // node pool shared by every bucket
+    int free_list = NIL;
+    std::vector<Bucket> buckets;
+    long long width = 1; // time units per bucket
+    size_t count = 0;
+    size_t current = 0; // bucket of the day being served
+    long long bucket_top = 1; // end (exclusive) of the day being served
+    bool located = false; // current's head is the minimum
+    uint64_t next_seq = 0;
+
+    int allocNode(const QueuedEvent& entry){
+        if(free_list == NIL){
+            nodes.push_back(Node{entry, NIL});
+            return static_cast<int>(nodes.size() - 1);
+        }
+        int node = free_list;
+        free_list = nodes[node].next;
+        nodes[node] = Node{entry, NIL};
+        return node;
+    }
+
+    // insert node into bucket in (time, seq) order; new events usually sort last, so try the tail first
+    void link(Bucket& bucket, int node){
+        const QueuedEvent& entry = nodes[node].entry;
+        if(bucket.head == NIL){
+            bucket.head = bucket.tail = node;
+        }else if(!entry.before(nodes[bucket.tail].entry)){
+            nodes[bucket.tail].next = node;
+            bucket.tail = node;
+        }else if(entry.before(nodes[bucket.head].entry)){
+            nodes[node].next = bucket.head;
+            bucket.head = node;
+        }else{
+            int prev = bucket.head;
+            while(!entry.before(nodes[nodes[prev].next].entry)) prev = nodes[prev].next;
+            nodes[node].next = nodes[prev].next;
+            nodes[prev].next = node;
+        }
+    }
+
+    long long dayOf(long long time) const{
+        return time >= 0 ? time / width : (time - width + 1) / width;
+    }
+
+    size_t bucketOf(long long time) const{
+        long long index = dayOf(time) % static_cast<long long>(buckets.size());
+        return static_cast<size_t>(index < 0 ? index + static_cast<long long>(buckets.size()) : index);
+    }
+
+    void setCurrentDay(long long time){
+        current = bucketOf(time);
+        bucket_top = (dayOf(time) + 1) * width;
+        located = false;
+    }
+
+    // point current at the bucket holding the earliest event
+    void locate(){
+        if(located) return;
+        size_t i = current;
+        long long top = bucket_top;
+        for(size_t n = 0; n < buckets.size(); ++n){
+            int head = buckets[i].head;
+            if(head != NIL && nodes[head].entry.event.event_time < top){
+                current = i;
+                bucket_top = top;
+                located = true;
+                return;
+            }
+            if(++i == buckets.size()) i = 0;
+            top += width;
+        }
+
+        // nothing due within a year, fall back to a direct search over the bucket heads
+        int best = NIL;
+        for(const auto& bucket : buckets){
+            if(bucket.head != NIL && (best == NIL || nodes[bucket.head].entry.before(nodes[best].entry))){
+                best = bucket.head;
+            }
+        }
+        setCurrentDay(nodes[best].entry.event.event_time);
+        located = true;
+    }
+
+    // rebuild with new_size buckets and a day width estimated from the average spacing of the earliest events
+    void resize(size_t new_size){
+        std::vector<int> pending;
+        pending.reserve(count);
+        for(const auto& bucket : buckets){
+            for(int node = bucket.head; node != NIL; node = nodes[node].next) pending.push_back(node);
+        }
+
+        size_t sample = std::min(pending.size(), WIDTH_SAMPLE);
+        partial_sort(pending.begin(), pending.begin() + sample, pending.end(),
+                     [this](int a, int b){ return nodes[a].entry.before(nodes[b].entry); });
+        if(sample > 1){
+            // average separation, then again ignoring gaps more than twice the first average
+            auto time_of = [this](int node){ return static_cast<long long>(nodes[node].entry.event.event_time); };
+            double average = static_cast<double>(time_of(pending[sample - 1]) - time_of(pending[0])) / (sample - 1);
+            long long kept_total = 0, kept = 0;
+            for(size_t k = 1; k < sample; ++k){
+                long long gap = time_of(pending[k]) - time_of(pending[k - 1]);
+                if(gap <= 2 * average){
+                    kept_total += gap;
+                    ++kept;
+                }
+            }
+            if(kept > 0) average = static_cast<double>(kept_total) / kept;
+            width = std::max(1LL, static_cast<long long>(3 * average));
+        }
+
+        buckets.assign(new_size, Bucket());
+        for(int node : pending){
+            nodes[node].next = NIL;
+            link(buckets[bucketOf(nodes[node].entry.event.event_time)], node);
+        }
+        if(!pending.empty()) setCurrentDay(nodes[pending[0]].entry.event.event_time);
+    }
+};
+
+// Read-only view of a whole file. mmap'd where available, read into memory otherwise.
+class MappedFile{
+public:
+    explicit MappedFile(const std::string& filename){
+#ifndef _WIN32
+        int fd = open(filename.c_str(), O_RDONLY);
+        if(fd < 0) return;
+        struct stat st;
+        if(fstat(fd, &st) == 0){
+            if(st.st_size == 0){
+                opened = true; // empty file, nothing to map
+            }else{
+                void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(addr != MAP_FAILED){
+                    madvise(addr, st.st_size, MADV_SEQUENTIAL); // parser walks the file front to back
+                    map_addr = addr;
+                    map_size = st.st_size;
+                    opened = true;
+                }
+            }
+        }
+        close(fd);
+#else
+        std::ifstream infile(filename, std::ios::binary);
+        if(!infile) return;
+        fallback.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+        opened = true;
+#endif
+    }
+
+    ~MappedFile(){
+#ifndef _WIN32
+        if(map_addr) munmap(map_addr, map_size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const{ return opened; }
+#ifndef _WIN32
+    const char* data() const{ return static_cast<const char*>(map_addr); }
+    size_t size() const{ return map_size; }
+#else
+    const char* data() const{ return fallback.data(); }
+    size_t size() const{ return fallback.size(); }
+#endif
+
+private:
+    bool opened = false;
+#ifndef _WIN32
+    void* map_addr = nullptr;
+    size_t map_size = 0;
+#else
+    std::vector<char> fallback;
+#endif
+};
+
+// Read-only view of one int column of a Workload.
+class IntColumn{
+public:
+    IntColumn() = default;
+    IntColumn(const int* data, size_t size): ptr(data), count(size) {}
+
+    const int& operator[](size_t i) const{ return ptr[i]; }
+    size_t size() const{ return count; }
+    bool empty() const{ return count == 0; }
+    const int* data() const{ return ptr; }
+    const int* begin() const{ return ptr; }
+    const int* end() const{ return ptr + count; }
+
+private:
+    const int* ptr = nullptr;
+    size_t count = 0;
+};
+
+// One I/O wait in a process's burst sequence: after the CPU burst before it, the process waits for io_time on
+// device, then needs cpu_time more CPU. A wait on SLEEP_DEVICE is a plain sleep (a timer, a lock, a reply from
+// another machine): it takes io_time however many other processes are asleep. The layout (three int32s) is part
+// of the binary workload format.
+struct IoStep{
+    int device;
+    int io_time;
+    int cpu_time;
+};
+
+const int MAX_IO_DEVICES = 1 << 16; // devices are numbered from 0, and the simulation keeps a queue per device
+const int SLEEP_DEVICE = -1;
+
+// The I/O steps of every process in CSR form: process i's steps are steps[offsets[i], offsets[i + 1]). A CPU-only
+// workload has none and the column is empty.
+class IoColumn{
+public:
+    IoColumn() = default;
+    IoColumn(const uint64_t* offsets, const IoStep* steps, size_t processes): offsets(offsets), steps(steps), count(processes) {}
+
+    bool empty() const{ return offsets == nullptr; }
+    const IoStep* begin(size_t proc) const{ return steps + offsets[proc]; }
+    const IoStep* end(size_t proc) const{ return steps + offsets[proc + 1]; }
+    size_t stepCount(size_t proc) const{ return empty() ? 0 : offsets[proc + 1] - offsets[proc]; }
+    size_t totalSteps() const{ return empty() ? 0 : offsets[count]; }
+
+    // devices referenced, i.e. the highest device number plus one
+    int deviceCount() const{
+        int devices = 0;
+        for(size_t i = 0; i < totalSteps(); ++i) devices = std::max(devices, steps[i].device + 1);
+        return devices;
+    }
+
+private:
+    const uint64_t* offsets = nullptr;
+    const IoStep* steps = nullptr;
+    size_t count = 0;
+};
+
+// Processes as read from the input, one column per field and indexed by the process's position in the input
+// (its dense index). Never changes once read, so any number of simulations can share one Workload.
+// Text input is parsed into columns the Workload owns; a binary workload file is used in place from its mapping,
+// and the Node addon's arrays in place from the JS heap.
+class Workload{
+public:
+    size_t size() const{ return mapping ? mapped_count : ids.size(); }
+    bool empty() const{ return size() == 0; }
+
+    IntColumn idColumn() const{ return mapping ? IntColumn(mapped_ids, mapped_count) : IntColumn(ids.data(), ids.size()); }
+    IntColumn arrivalColumn() const{ return mapping ? IntColumn(mapped_arrivals, mapped_count) : IntColumn(arrivals.data(), arrivals.size()); }
+    IntColumn burstColumn() const{ return mapping ? IntColumn(mapped_bursts, mapped_count) : IntColumn(bursts.data(), bursts.size()); }
+    // nice values, or an empty column when every process is nice 0 (the column only exists once one isn't)
+    IntColumn niceColumn() const{
+        if(mapping) return IntColumn(mapped_nices, mapped_nices ? mapped_count : 0);
+        return IntColumn(nices.data(), nices.size());
+    }
+    // I/O steps, or an empty column when every process is a single CPU burst. The burst column holds each
+    // process's total CPU time across all its bursts.
+    IoColumn ioColumn() const{
+        if(mapping) return mapped_io_offsets ? IoColumn(mapped_io_offsets, mapped_io_steps, mapped_count) : IoColumn();
+        return io_offsets.empty() ? IoColumn() : IoColumn(io_offsets.data(), io_steps.data(), ids.size());
+    }
+
+    void reserve(size_t n){
+        ids.reserve(n);
+        arrivals.reserve(n);
+        bursts.reserve(n);
+    }
+
+    void add(int id, int arrival, int burst, int nice = 0){
+        ids.push_back(id); //unique process IDs for incomming processes
+        arrivals.push_back(arrival); // Arrival time and total CPU burst time of the process.
+        bursts.push_back(burst);
+        if(nice != 0 && nices.empty()) nices.assign(ids.size() - 1, 0);
+        if(!nices.empty()) nices.push_back(nice);
+        if(!io_offsets.empty()) io_offsets.push_back(io_offsets.back());
+    }
+
+    // the process added last goes on to step after its CPU so far; its burst grows by step.cpu_time
+    void addIoStep(const IoStep& step){
+        if(io_offsets.empty()) io_offsets.assign(ids.size() + 1, 0); // the I/O columns only exist once needed
+        io_steps.push_back(step);
+        ++io_offsets.back();
+        bursts.back() += step.cpu_time;
+    }
+
+    // size the owned columns to n processes and hand them out to be filled in place, e.g. by several threads
+    void resize(size_t n, int*& id_data, int*& arrival_data, int*& burst_data){
+        ids.resize(n);
+        arrivals.resize(n);
+        bursts.resize(n);
+        nices.clear();
+        io_offsets.clear();
+        io_steps.clear();
+        id_data = ids.data();
+        arrival_data = arrivals.data();
+        burst_data = bursts.data();
+    }
+
+    // append every process of other after ours
+    void append(const Workload& other){
+        IntColumn other_ids = other.idColumn(), other_arrivals = other.arrivalColumn(), other_bursts = other.burstColumn();
+        IntColumn other_nices = other.niceColumn();
+        if(!nices.empty() || !other_nices.empty()){
+            nices.resize(ids.size(), 0);
+            if(other_nices.empty()) nices.resize(ids.size() + other_ids.size(), 0);
+            else nices.insert(nices.end(), other_nices.begin(), other_nices.end());
+        }
+        IoColumn other_io = other.ioColumn();
+        if(!io_offsets.empty() || !other_io.empty()){
+            if(io_offsets.empty()) io_offsets.assign(ids.size() + 1, 0);
+            for(size_t i = 0; i < other_ids.size(); ++i){
+                if(!other_io.empty()) io_steps.insert(io_steps.end(), other_io.begin(i), other_io.end(i));
+                io_offsets.push_back(io_steps.size());
+            }
+        }
+        ids.insert(ids.end(), other_ids.begin(), other_ids.end());
+        arrivals.insert(arrivals.end(), other_arrivals.begin(), other_arrivals.end());
+        bursts.insert(bursts.end(), other_bursts.begin(), other_bursts.end());
+    }
+
+    // columns living in memory the Workload doesn't own, such as a mapped file; owner (never null) keeps that
+    // memory alive as long as any copy of the Workload does
+    static Workload mapped(std::shared_ptr<const void> owner, const int* ids, const int* arrivals, const int* bursts,
+                           const int* nices, const uint64_t* io_offsets, const IoStep* io_steps, size_t count){
+        Workload workload;
+        workload.mapped_io_offsets = io_offsets;
+        workload.mapped_io_steps = io_steps;
+        workload.mapping = std::move(owner);
+        workload.mapped_ids = ids;
+        workload.mapped_arrivals = arrivals;
+        workload.mapped_bursts = bursts;
+        workload.mapped_nices = nices;
+        workload.mapped_count = count;
+        return workload;
+    }
+
+private:
+    std::vector<int> ids, arrivals, bursts, nices;
+    std::vector<uint64_t> io_offsets; // empty, or one more than the number of processes
+    std::vector<IoStep> io_steps;
+    std::shared_ptr<const void> mapping;
+    const int* mapped_ids = nullptr;
+    const int* mapped_arrivals = nullptr;
+    const int* mapped_bursts = nullptr;
+    const int* mapped_nices = nullptr; // null when the file has no nice column
+    const uint64_t* mapped_io_offsets = nullptr; // null when the file has no I/O steps
+    const IoStep* mapped_io_steps = nullptr;
+    size_t mapped_count = 0;
+};
+
+// index of the lowest set bit of a non-zero mask, in one instruction
+inline int lowestSetBit(uint64_t bits){
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// index of the highest set bit of a non-zero value, likewise
+inline int highestSetBit(uint64_t bits){
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(bits);
+#endif
+}
+
+// HDR-style histogram of non-negative times: values below 2^SUB_BUCKET_BITS get a bucket each, larger values
+// share buckets whose width doubles with every power of two, so any value is reported to within
+// 1/2^(SUB_BUCKET_BITS-1) of itself using a fixed few thousand counters whatever the range.
+class LatencyHistogram{
+public:
+    static const int SUB_BUCKET_BITS = 7;
+
+    LatencyHistogram(): counts(bucketIndex(std::numeric_limits<long long>::max()) + 1, 0) {}
+
+    void record(long long value){
+        ++counts[bucketIndex(std::max(0LL, value))];
+        ++total;
+    }
+
+    void merge(const LatencyHistogram& other){
+        for(size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        total += other.total;
+    }
+
+    long long count() const{ return total; }
+
+    // the non-empty buckets as (index, count), and adding one back: a compact copy of the histogram for snapshots
+    std::vector<std::pair<uint32_t, long long>> buckets() const{
+        std::vector<std::pair<uint32_t, long long>> non_empty;
+        for(size_t i = 0; i < counts.size(); ++i){
+            if(counts[i]) non_empty.emplace_back(static_cast<uint32_t>(i), counts[i]);
+        }
+        return non_empty;
+    }
+
+    bool addBucket(size_t index, long long count){
+        if(index >= counts.size() || count < 0) return false;
+        counts[index] += count;
+        total += count;
+        return true;
+    }
+
+    // smallest recorded value v such that at least percent% of the recorded values are <= v (to bucket precision)
+    long long percentile(double percent) const{
+        if(total == 0) return 0;
+        long long target = std::max(1LL, static_cast<long long>(ceil(percent / 100.0 * total)));
+        long long seen = 0;
+        for(size_t i = 0; i < counts.size(); ++i){
+            seen += counts[i];
+            if(seen >= target) return highestInBucket(i);
+        }
+        return highestInBucket(counts.size() - 1);
+    }
+
+private:
+    static const long long HALF = 1LL << (SUB_BUCKET_BITS - 1);
+    std::vector<long long> counts;
+    long long total = 0;
+
+    static size_t bucketIndex(long long value){
+        if(value < 2 * HALF) return static_cast<size_t>(value);
+        int msb = highestSetBit(static_cast<uint64_t>(value));
+        int shift = msb - (SUB_BUCKET_BITS - 1);
+        return static_cast<size_t>(shift * HALF + (value >> shift));
+    }
+
+    static long long highestInBucket(size_t index){
+        if(index < static_cast<size_t>(2 * HALF)) return static_cast<long long>(index);
+        long long shift = static_cast<long long>(index) / HALF - 1;
+        long long sub_bucket = static_cast<long long>(index) - shift * HALF;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+};
+
+// Constant-memory metrics updated as each process completes: 64-bit sums for the means and a histogram per
+// metric for the tail percentiles, so a run can drop its per-process records entirely.
+struct StreamingMetrics{
+    long long completed = 0;
+    long long total_tat = 0, total_wt = 0, total_rt = 0;
+    long long makespan = 0; // latest completion time
+    LatencyHistogram turnaround, waiting, response;
+
+    // service is the CPU time, plus the I/O time of a process that does I/O
+    void record(int arrival, long long service, int start, int end){
+        long long tat = static_cast<long long>(end) - arrival; // TAT = completion - arrival
+        long long wt = tat - service; // Waiting time = TAT - Service Time
+        long long rt = static_cast<long long>(start) - arrival; // first dispatch - arrival
+        ++completed;
+        total_tat += tat;
+        total_wt += wt;
+        total_rt += rt;
+        makespan = std::max<long long>(makespan, end);
+        turnaround.record(tat);
+        waiting.record(wt);
+        response.record(rt);
+    }
+
+    void merge(const StreamingMetrics& other){
+        completed += other.completed;
+        total_tat += other.total_tat;
+        total_wt += other.total_wt;
+        total_rt += other.total_rt;
+        makespan = std::max(makespan, other.makespan);
+        turnaround.merge(other.turnaround);
+        waiting.merge(other.waiting);
+        response.merge(other.response);
+    }
+
+    double mean(long long total) const{ return completed ? static_cast<double>(total) / completed : 0.0; }
+};
+
+// what a TraceRecord marks
+enum class TraceKind : uint8_t{
+    DISPATCH, // the process was put on the core; value is the context switch time before it starts running
+    PREEMPT, // it was taken off mid-slice; value is how long it had run
+    TIMER, // its slice ran out with work left; value is the slice
+    BLOCK, // its CPU burst ran out and it went off to I/O; value is the slice
+    COMPLETE // it finished; value is the last slice
+};
+
+// one entry of an ExecutionTrace, 16 bytes
+struct TraceRecord{
+    int32_t time;
+    int32_t process; // dense index
+    int32_t value;
+    uint16_t core;
+    TraceKind kind;
+    uint8_t reserved;
+};
+
+// The execution timeline of a run: every dispatch and every end of a slice, as fixed-size records in a ring
+// buffer that is allocated and touched up front, so recording one is a store and an increment. Once the ring is
+// full it keeps the latest capacity records. Builds configured with -DSCHEDULER_TRACE=OFF define
+// SCHEDULER_NO_TRACE, and the engines' TRACE_EVENTs compile to nothing.
+class ExecutionTrace{
+public:
+    explicit ExecutionTrace(size_t capacity): records(roundUp(capacity)), mask(records.size() - 1) {}
+
+    void record(TraceKind kind, int time, int proc, int value, int core = 0){
+        records[next & mask] = TraceRecord{time, proc, value, static_cast<uint16_t>(core), kind, 0};
+        ++next;
+    }
+
+    size_t capacity() const{ return records.size(); }
+    uint64_t recorded() const{ return next; }
+    uint64_t dropped() const{ return next > records.size() ? next - records.size() : 0; }
+
+    // the records still in the ring, oldest first
+    template<class Visit>
+    void forEach(Visit visit) const{
+        for(uint64_t i = dropped(); i < next; ++i) visit(records[i & mask]);
+    }
+
+private:
+    std::vector<TraceRecord> records;
+    uint64_t mask;
+    uint64_t next = 0;
+
+    // capacity as a power of two, so the ring index is a mask
+    static size_t roundUp(size_t capacity){
+        size_t size = 1;
+        while(size < capacity) size <<= 1;
+        return size;
+    }
+};
+
+#ifdef SCHEDULER_NO_TRACE
+#define TRACE_EVENT(trace, ...) do{}while(false)
+#else
+#define TRACE_EVENT(trace, ...) do{ if(trace) (trace)->record(__VA_ARGS__); }while(false)
+#endif
+
+// names of the EventTypes, in enum order, for reports
+const char* const EVENT_TYPE_NAMES[] = {"ARRIVAL", "COMPLETION", "TIME_SLICE", "BLOCK", "UNBLOCK"};
+const int EVENT_TYPE_COUNT = 5;
+
+// wall-clock time and, on x86, TSC cycles spent in one phase of a run
+struct PhaseTiming{
+    const char* name;
+    double seconds;
+    uint64_t cycles; // 0 where there is no cycle counter
+};
+
+// The simulator's own instrumentation (--stats): the events the event loop handled by type, how deep the event
+// queue and the ready set were as each of them came up, and how long each phase of the run took. The engines
+// only reach it through a pointer they check, so a run without it pays a predictable branch per event.
+struct SimulatorStats{
+    static const int LENGTH_BUCKETS = 33; // ready set lengths 0, 1, 2-3, 4-7, ..., 2^31 and up
+
+    long long events[EVENT_TYPE_COUNT] = {};
+    long long preemptions = 0; // slices cut short, whose end never comes up as an event
+    size_t max_event_queue = 0, max_ready = 0;
+    long long total_event_queue = 0, total_ready = 0; // summed over the events, for the means
+    long long ready_lengths[LENGTH_BUCKETS] = {}; // events by the ready set length they saw, in power-of-two buckets
+    std::vector<PhaseTiming> phases;
+
+    void sample(EventType type, size_t event_queue, size_t ready){
+        ++events[static_cast<int>(type)];
+        max_event_queue = std::max(max_event_queue, event_queue);
+        max_ready = std::max(max_ready, ready);
+        total_event_queue += static_cast<long long>(event_queue);
+        total_ready += static_cast<long long>(ready);
+        ++ready_lengths[ready ? std::min(LENGTH_BUCKETS - 1, highestSetBit(ready) + 1) : 0];
+    }
+
+    long long eventCount() const{
+        long long count = 0;
+        for(long long n : events) count += n;
+        return count;
+    }
+
+    // forget the last run's counters, keeping the phases timed so far
+    void resetCounters(){
+        std::vector<PhaseTiming> timed = std::move(phases);
+        *this = SimulatorStats();
+        phases = std::move(timed);
+    }
+};
+
+// the TSC on x86, 0 elsewhere
+uint64_t cycleCounter();
+
+// run phase, timing it into stats when that's set
+template<class Phase>
+void timePhase(SimulatorStats* stats, const char* name, Phase phase){
+    if(!stats){
+        phase();
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    uint64_t cycles = cycleCounter();
+    phase();
+    cycles = cycleCounter() - cycles;
+    stats->phases.push_back(PhaseTiming{name, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), cycles});
+}
+
+// Per-run process table laid out as one column per field, indexed by dense process index.
+// The event loop only touches the hot columns; ids, input and metric columns stay out of its cache lines.
+// The input columns are views into a shared Workload, so each concurrent run only owns its run state.
+class ProcessTable{
+public:
+    // hot: read and written on every event
+    std::vector<int> remaining_time; // Remaining time of the current CPU burst.
+    std::vector<int> start_time, end_time; // Start and end times of process execution.
+
+    // cold: input columns, read at dispatch and when reporting
+    const IntColumn p_id;
+    const IntColumn arrival_time;
+    const IntColumn burst_time;
+    const IntColumn nice; // empty when every process is nice 0
+    const IoColumn io; // empty when every process is a single CPU burst
+
+    // cold: filled by calculateMetrics
+    std::vector<int> turnaround_time, waiting_time, response_time; // Performance metrics.
+
+    StreamingMetrics* metrics = nullptr; // fed every completion when set
+    ExecutionTrace* trace = nullptr; // fed every dispatch and end of a slice when set
+    SimulatorStats* stats = nullptr; // fed every event when set
+    bool keep_records = true; // without records there are no end_time or metric columns, only metrics
+    long long events = 0; // scheduling events (arrivals and ends of slices) the last run went through
+    long long switches = 0, switch_time = 0; // context switches in the last run and the CPU time they took
+
+    // I/O runs only: the next I/O step of each process, and how long the CPU and each device were busy and how
+    // long the CPU was busy while some device was too
+    std::vector<int> next_io;
+    long long cpu_busy_time = 0, overlap_time = 0;
+    std::vector<long long> device_busy_time;
+
+    explicit ProcessTable(const Workload& workload):
+      p_id(workload.idColumn()), arrival_time(workload.arrivalColumn()), burst_time(workload.burstColumn()),
+      nice(workload.niceColumn()), io(workload.ioColumn()) {}
+
+    size_t size() const{ return p_id.size(); }
+    bool empty() const{ return p_id.empty(); }
+
+    // size the per-run columns and reset them, so the same table can be simulated again
+    void resetRunState(){
+        remaining_time.assign(burst_time.begin(), burst_time.end());
+        if(!io.empty()){
+            for(size_t i = 0; i < size(); ++i) remaining_time[i] = firstBurst(i);
+            next_io.assign(size(), 0);
+            device_busy_time.assign(io.deviceCount(), 0);
+        }
+        cpu_busy_time = 0;
+        overlap_time = 0;
+        start_time.assign(size(), 0);
+        size_t records = keep_records ? size() : 0;
+        end_time.assign(records, 0);
+        turnaround_time.assign(records, 0);
+        waiting_time.assign(records, 0);
+        response_time.assign(records, 0);
+        if(metrics) *metrics = StreamingMetrics();
+        if(stats) stats->resetCounters();
+        events = 0;
+        switches = 0;
+        switch_time = 0;
+    }
+
+    // the engines call this as each process finishes
+    void complete(int proc, int time){
+        if(keep_records) end_time[proc] = time;
+        if(metrics) metrics->record(arrival_time[proc], serviceTime(proc), start_time[proc], time);
+    }
+
+    // CPU time before the first I/O
+    int firstBurst(size_t proc) const{
+        int burst = burst_time[proc];
+        for(size_t s = 0; s < io.stepCount(proc); ++s) burst -= io.begin(proc)[s].cpu_time;
+        return burst;
+    }
+
+    // CPU and I/O time: what the process would take with the machine to itself
+    long long serviceTime(size_t proc) const{
+        long long service = burst_time[proc];
+        for(size_t s = 0; s < io.stepCount(proc); ++s) service += io.begin(proc)[s].io_time;
+        return service;
+    }
+};
+
+const int SWITCH_TIME = 2; //context switch time between processes, because naturally it takes time to save and load new process.
+
+// how the cache-warmup penalty grows with the time a process has spent off the CPU
+enum class WarmupCurve{
+    LINEAR, // cold after warmup_time
+    EXPONENTIAL // half cold after warmup_time, three quarters after twice that, ...
+};
+
+// Cost of a context switch, simulated as CPU time between a dispatch and the process starting to run. Charged
+// whenever the process put on a CPU isn't the one whose context that CPU already holds: a fixed cost for the
+// switch itself, plus a cache-warmup penalty of up to warmup for a working set that went cold while the process
+// was away. A process that has never run, or last ran on another core, starts fully cold.
+struct SwitchCostModel{
+    static const long long COLD = -1; // off_for of a process with nothing left in this CPU's cache
+
+    int fixed = SWITCH_TIME;
+    int warmup = 0; // penalty for a fully cold cache; 0 leaves just the fixed cost
+    int warmup_time = 100;
+    WarmupCurve curve = WarmupCurve::LINEAR;
+
+    int cost(long long off_for) const{
+        if(warmup == 0) return fixed;
+        if(off_for == COLD || warmup_time <= 0) return fixed + warmup;
+        double cold = curve == WarmupCurve::LINEAR ? std::min(1.0, static_cast<double>(off_for) / warmup_time)
+                                                   : 1.0 - std::exp2(-static_cast<double>(off_for) / warmup_time);
+        return fixed + static_cast<int>(std::lround(warmup * cold));
+    }
+};
+
+enum class OutputFormat{HUMAN, CSV, JSONL};
+
+const int NO_PROCESS = -1; // marks an idle CPU
+
+// multi-CPU runs: which core an arriving process is queued on
+enum class CorePlacement{ROUND_ROBIN, SHORTEST_QUEUE};
+// multi-CPU runs: what a core does when its own ready queue is empty
+enum class StealPolicy{NONE, IDLE}; // stay idle, or take the newest waiting process from the longest other queue
+
+const int MLFQ_MAX_LEVELS = 64; // one bit per level in a 64-bit mask
+
+// scheduling policies, each a policy class in policies.h (FCFS and RR also run on the multi-CPU engine)
+enum class SchedulingPolicy{
+    FCFS,
+    RR,
+    SJF, // shortest job first, non-preemptive
+    SRTF, // shortest remaining time first: an arrival with less work left preempts the running process
+    CFS, // completely fair: weighted by nice value, the process with the least virtual runtime runs next
+    MLFQ // multi-level feedback queue: demoted a level each time it uses up its quantum, boosted back periodically
+};
+
+// short names, in enum order, as the web UI and reports use them
+const char* const POLICY_NAMES[] = {"FCFS", "RR", "SJF", "SRTF", "CFS", "MLFQ"};
+const int POLICY_COUNT = 6;
+inline const char* policyName(SchedulingPolicy policy){ return POLICY_NAMES[static_cast<int>(policy)]; }
+
+// how runSimulation should run a workload
+struct SimulationOptions{
+    EventQueueKind queue_kind = EventQueueKind::HEAP;
+    bool rr_fast_forward = false; // run RR on the round-skipping engine instead of the event loop
+    bool verify_rr = false; // run RR on both engines and check they agree
+    int cores = 1; // number of simulated CPUs, each with its own ready queue
+    CorePlacement placement = CorePlacement::ROUND_ROBIN;
+    StealPolicy steal = StealPolicy::IDLE;
+    bool summary_only = false; // keep no per-process records, report only the streaming metrics
+    OutputFormat format = OutputFormat::HUMAN;
+    SwitchCostModel switch_cost;
+    // CFS: every runnable process gets a slice within target_latency, in proportion to its weight, until there
+    // are so many that the period has to stretch to give each at least min_granularity
+    int target_latency = 24;
+    int min_granularity = 3;
+    // MLFQ: the quantum of each level from the top (at most MLFQ_MAX_LEVELS), and how often every process is
+    // boosted back to the top level (0 never)
+    std::vector<int> mlfq_quanta = {4, 8, 16, 32};
+    int mlfq_boost_period = 200;
+    // record the run's execution timeline and write it to this Chrome trace JSON file (see writeChromeTrace),
+    // keeping the latest timeline_capacity records
+    std::string timeline;
+    size_t timeline_capacity = 1 << 22;
+};
+
+// where prompts and side reports go: stdout for people, stderr when stdout carries CSV or JSON
+inline std::ostream& infoStream(const SimulationOptions& options){
+    return options.format == OutputFormat::HUMAN ? std::cout : std::cerr;
+}
+
+// per-core counters of a multi-CPU run
+struct MultiCoreStats{
+    std::vector<long long> busy_time; // time each core spent running processes
+    std::vector<long long> dispatches; // processes put on each core
+    std::vector<long long> migrations; // dispatches onto a core other than the one the process last ran on
+    long long steals = 0; // processes taken from another core's ready queue
+};
+
+// What a scheduling policy keeps between events, independent of its data structures: the ready processes in the
+// order it would dispatch them, plus per-process values and counters for policies with state of their own (see
+// save() and restore() in policies.h).
+struct PolicyState{
+    std::vector<int> ready;
+    std::vector<long long> per_process;
+    std::vector<long long> counters;
+};
+
+// Everything a single-CPU simulation needs to carry on from an instant: every event before time has been handled
+// and none at or after it. It is all flat arrays, so taking a snapshot or resuming from one costs a copy at memory
+// speed, and writeSnapshot() can store it as it is.
+struct SimulationSnapshot{
+    SchedulingPolicy policy = SchedulingPolicy::FCFS; // what ran up to time
+    int time_quantum = 0;
+    long long time = 0;
+    uint64_t process_count = 0; // processes in the workload it ran
+    uint64_t workload_hash = 0; // of their arrival and burst columns, so it only resumes on the same workload
+    uint64_t next_arrival = 0; // processes delivered so far, in arrival order
+    int current_process = NO_PROCESS, current_slice = 0, slice_start = 0; // the slice on the CPU, if any
+    std::vector<Event> pending; // the event queue in pop order: the running slice's end and the I/O in flight
+    std::vector<std::vector<int>> device_queues; // waiting on each device, the one in service first
+    int busy_devices = 0, last_time = 0;
+    long long total_execution_time = 0;
+    PolicyState policy_state;
+    int loaded = NO_PROCESS; // whose context the CPU holds
+    std::vector<int> left_at, left_core; // when and where each process left the CPU, with a warmup penalty
+
+    // the ProcessTable's run state
+    bool keep_records = true;
+    std::vector<int> remaining_time, start_time, end_time, next_io;
+    long long events = 0, switches = 0, switch_time = 0, cpu_busy_time = 0, overlap_time = 0;
+    std::vector<long long> device_busy_time;
+    bool has_metrics = false;
+    StreamingMetrics metrics;
+};
+
+// A single-CPU simulation that runs in steps, so it can be paused at any instant and saved. Any number of runs
+// can be resumed from one snapshot, each on its own ProcessTable (and thread), to branch off the same prefix.
+class SteppedSimulation{
+public:
+    virtual ~SteppedSimulation() = default;
+    // handle every event before time; true once the whole workload has run
+    virtual bool runUntil(long long time) = 0;
+    // the state as of the time the last runUntil stopped at
+    virtual void save(SimulationSnapshot& snapshot) const = 0;
+    virtual long long totalExecutionTime() const = 0;
+};
+
+// Fixed set of worker threads that run batches of independent tasks. Each worker owns a deque of task indices
+// seeded with a contiguous block of the batch; it takes work from the back of its own deque and steals from the
+// front of the others once it runs dry, so batches of uneven tasks (RR at tiny quanta next to RR at huge ones)
+// still keep every core busy until the end.
+class WorkStealingPool{
+public:
+    explicit WorkStealingPool(unsigned num_threads = std::thread::hardware_concurrency()){
+        num_threads = std::max(1u, num_threads);
+        for(unsigned i = 0; i < num_threads; ++i) queues.emplace_back(new TaskQueue());
+        for(unsigned i = 0; i < num_threads; ++i) workers.emplace_back([this, i]{ workerLoop(i); });
+    }
+
+    ~WorkStealingPool(){
+        {
+            std::lock_guard<std::mutex> lock(batch_lock);
+            stopping = true;
+        }
+        batch_ready.notify_all();
+        for(auto& worker : workers) worker.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const{ return static_cast<unsigned>(workers.size()); }
+
+    // call task(i) for every i in [0, task_count) across the workers, and return once all of them have finished
+    void run(size_t task_count, const std::function<void(size_t)>& task){
+        if(task_count == 0) return;
+        size_t per_worker = (task_count + queues.size() - 1) / queues.size();
+        for(size_t w = 0; w < queues.size(); ++w){
+            std::lock_guard<std::mutex> lock(queues[w]->lock);
+            for(size_t i = w * per_worker; i < std::min(task_count, (w + 1) * per_worker); ++i) queues[w]->tasks.push_back(i);
+        }
+
+        std::unique_lock<std::mutex> lock(batch_lock);
+        current_task = &task;
+        active_workers = size();
+        ++generation;
+        batch_ready.notify_all();
+        batch_done.wait(lock, [this]{ return active_workers == 0; });
+        current_task = nullptr;
+    }
+
+private:
+    struct TaskQueue{
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex batch_lock;
+    std::condition_variable batch_ready, batch_done;
+    const std::function<void(size_t)>* current_task = nullptr;
+    uint64_t generation = 0;
+    unsigned active_workers = 0;
+    bool stopping = false;
+
+    bool nextTask(unsigned self, size_t& index){
+        {
+            std::lock_guard<std::mutex> lock(queues[self]->lock);
+            if(!queues[self]->tasks.empty()){
+                index = queues[self]->tasks.back();
+                queues[self]->tasks.pop_back();
+                return true;
+            }
+        }
+        for(size_t offset = 1; offset < queues.size(); ++offset){
+            TaskQueue& victim = *queues[(self + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.lock);
+            if(!victim.tasks.empty()){
+                index = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned self){
+        uint64_t seen = 0;
+        while(true){
+            const std::function<void(size_t)>* task;
+            {
+                std::unique_lock<std::mutex> lock(batch_lock);
+                batch_ready.wait(lock, [&]{ return stopping || generation != seen; });
+                if(stopping) return;
+                seen = generation;
+                task = current_task;
+            }
+            size_t index;
+            while(nextTask(self, index)) (*task)(index);
+            {
+                std::lock_guard<std::mutex> lock(batch_lock);
+                if(--active_workers == 0) batch_done.notify_all();
+            }
+        }
+    }
+};
+
+
+// calculate per-process metrics and their averages from a run that kept its records
+void calculateMetrics(ProcessTable& processes, float& avg_rt, float& avg_tat, float& avg_wt, float& cpu_efficiency, long long total_execution_time, long long total_switch_time);
+// print the results of a run that kept its records / of a run that only kept streaming metrics
+void displayResults(const ProcessTable& processes, const float avg_rt, const float avg_tat, const float avg_wt, const float cpu_efficiency, OutputFormat format = OutputFormat::HUMAN);
+void displaySummary(const StreamingMetrics& metrics, long long total_execution_time, long long total_switch_time, OutputFormat format = OutputFormat::HUMAN);
+void displayCoreStats(long long makespan, const MultiCoreStats& stats, std::ostream& out);
+// Write trace as Chrome trace event JSON, which chrome://tracing and ui.perfetto.dev open: a track per CPU with a
+// span per slice named after the process id and a span per context switch, one time unit per microsecond
+bool writeChromeTrace(const ExecutionTrace& trace, const ProcessTable& processes, const std::string& title, const std::string& filename);
+// the --stats report: events by type, queue depths, the ready set length histogram and the phase timings
+void displayStats(const SimulatorStats& stats, std::ostream& out);
+
+// engines, each returns the total CPU execution time
+long long simulateRoundRobinFastForward(ProcessTable& processes, int time_quantum, const SwitchCostModel& switch_cost = SwitchCostModel());
+long long simulateProcesses(ProcessTable& processes,int time_quantum,SchedulingPolicy policy,const SimulationOptions& options,MultiCoreStats* core_stats = nullptr);
+bool verifyRoundRobinEngines(const ProcessTable& processes, int time_quantum, const SimulationOptions& options, std::ostream& info);
+const char* unsupportedRun(const ProcessTable& processes, SchedulingPolicy policy, const SimulationOptions& options);
+// checks a run handed in by a client (a daemon request or the Node addon), whose columns never went through
+// readProcesses: an error message, or empty when it can be simulated
+std::string invalidRun(const ProcessTable& processes, SchedulingPolicy policy, int time_quantum, const SimulationOptions& options);
+bool runSimulation(ProcessTable& processes,int time_quantum,SchedulingPolicy policy,const SimulationOptions& options = SimulationOptions());
+
+// Single-CPU runs in steps (nullptr, with error set, for a multi-CPU run). resumeSimulation carries on from a
+// snapshot taken on the same workload, optionally with processes added at the end that arrive at or after the
+// snapshot's time. The same policy continues exactly where it was; another one takes over the ready processes in
+// their saved order and the running one as if it had been preempted at that time.
+std::unique_ptr<SteppedSimulation> startSimulation(ProcessTable& processes, int time_quantum, SchedulingPolicy policy,
+                                                   const SimulationOptions& options, std::string& error);
+std::unique_ptr<SteppedSimulation> resumeSimulation(const SimulationSnapshot& snapshot, ProcessTable& processes,
+                                                    int time_quantum, SchedulingPolicy policy,
+                                                    const SimulationOptions& options, std::string& error);
+
+// RR parameter sweep over quantum x switch time
+void runSweep(const Workload& workload, const std::vector<int>& quanta, const std::vector<int>& switch_times, const SimulationOptions& options);
+bool parseSweepValues(const std::string& spec, std::vector<int>& values);
+
+// "RR:8" or "CFS" (case doesn't matter); a policy without a quantum gets default_quantum
+bool parsePolicySpec(const std::string& spec, int default_quantum, SchedulingPolicy& policy, int& time_quantum);
+
+// one run of a batch: a policy and its quantum
+struct BatchRun{
+    std::string spec; // as given on the command line, to label its results
+    SchedulingPolicy policy = SchedulingPolicy::FCFS;
+    int time_quantum = 0;
+};
+
+// comma-separated POLICY[:quantum] runs, or "all" for every policy the options support on workload, RR at
+// default_quantum
+bool parseBatchRuns(const std::string& spec, int default_quantum, const Workload& workload, const SimulationOptions& options,
+                    std::vector<BatchRun>& runs, std::string& error);
+// Batch mode: simulate workload under every run, spread over threads (0 for one per core), each on its own run
+// state over the shared input columns, and print one table comparing them. Fails, with error set, when the options
+// can't run one of them.
+bool runBatch(const Workload& workload, const std::vector<BatchRun>& runs, const SimulationOptions& options,
+              unsigned threads, std::string& error);
+
+// workload input, text or binary; num_processes < 0 reads every process
+Workload readProcesses(const std::string& filename, int num_processes);
+Workload readProcessesStream(const std::string& filename, int num_processes);
+const char* parseProcessRecords(const char* pos, const char* end, int limit, Workload& out);
+bool isBinaryWorkload(const MappedFile& file);
+bool mapBinaryWorkload(std::shared_ptr<const MappedFile> file, int num_processes, Workload& out, std::string& error);
+bool writeBinaryWorkload(const Workload& workload, const std::string& filename);
+bool writeTextWorkload(const Workload& workload, const std::string& filename); // "-" writes to stdout
+int convertWorkload(const std::string& input, const std::string& output);
+
+#endif // SCHEDULER_H
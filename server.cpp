@@ -0,0 +1,373 @@
+#include "server.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <list>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+// Simulation jobs from every connection, run by a fixed set of threads. Connections only read frames and wait
+// for their batch, so the number of simulations running at once stays at the number of workers however many
+// clients there are.
+class JobQueue{
+public:
+    explicit JobQueue(unsigned threads){
+        for(unsigned i = 0; i < max(1u, threads); ++i) workers.emplace_back([this]{ workerLoop(); });
+    }
+
+    ~JobQueue(){
+        {
+            lock_guard<mutex> lock(jobs_lock);
+            stopping = true;
+        }
+        jobs_ready.notify_all();
+        for(auto& worker : workers) worker.join();
+    }
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    unsigned size() const{ return static_cast<unsigned>(workers.size()); }
+
+    void push(function<void()> job){
+        {
+            lock_guard<mutex> lock(jobs_lock);
+            jobs.push_back(move(job));
+        }
+        jobs_ready.notify_one();
+    }
+
+private:
+    vector<thread> workers;
+    mutex jobs_lock;
+    condition_variable jobs_ready;
+    deque<function<void()>> jobs;
+    bool stopping = false;
+
+    void workerLoop(){
+        while(true){
+            function<void()> job;
+            {
+                unique_lock<mutex> lock(jobs_lock);
+                jobs_ready.wait(lock, [this]{ return stopping || !jobs.empty(); });
+                if(jobs.empty()) return;
+                job = move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+};
+
+// The threads serving connections, at most limit of them at a time. Each closes its socket as it finishes, under
+// the lock, so stop() can shut the live ones' sockets down without hitting a descriptor reused since; stop() then
+// waits for them, so no connection outlives the job queue it pushes to.
+class ConnectionThreads{
+public:
+    explicit ConnectionThreads(size_t limit): limit(max<size_t>(1, limit)) {}
+
+    ~ConnectionThreads(){ stop(); }
+
+    ConnectionThreads(const ConnectionThreads&) = delete;
+    ConnectionThreads& operator=(const ConnectionThreads&) = delete;
+
+    // serve(fd) on a thread of its own, once fewer than limit connections are being served
+    void start(int fd, function<void(int)> serve){
+        unique_lock<mutex> lock(connections_lock);
+        slot_free.wait(lock, [this]{ reapFinished(); return connections.size() < limit; });
+        connections.emplace_back();
+        Connection& connection = connections.back();
+        connection.fd = fd;
+        connection.worker = thread([this, &connection, fd, serve]{
+            serve(fd);
+            lock_guard<mutex> done(connections_lock);
+            close(fd);
+            connection.finished = true;
+            slot_free.notify_all();
+        });
+    }
+
+    void stop(){
+        unique_lock<mutex> lock(connections_lock);
+        for(Connection& connection : connections){
+            if(!connection.finished) shutdown(connection.fd, SHUT_RDWR); // its reads and writes fail from now on
+        }
+        slot_free.wait(lock, [this]{ reapFinished(); return connections.empty(); });
+    }
+
+private:
+    struct Connection{
+        int fd = -1;
+        thread worker;
+        bool finished = false;
+    };
+
+    size_t limit;
+    list<Connection> connections; // stable addresses, each thread marks its own entry finished
+    mutex connections_lock;
+    condition_variable slot_free;
+
+    // with connections_lock held: join the finished threads
+    void reapFinished(){
+        for(auto it = connections.begin(); it != connections.end();){
+            if(!it->finished){
+                ++it;
+                continue;
+            }
+            it->worker.join(); // done with the lock already, only returning
+            it = connections.erase(it);
+        }
+    }
+};
+
+// bounds-checked reads from a frame payload
+class FrameReader{
+public:
+    FrameReader(const char* data, size_t size): pos(data), end(data + size) {}
+
+    template<class T>
+    bool read(T& value){
+        const char* bytes = take(sizeof(T));
+        if(bytes) memcpy(&value, bytes, sizeof(T));
+        return bytes != nullptr;
+    }
+
+    // the next n bytes, or nullptr when the payload is shorter
+    const char* take(size_t n){
+        if(static_cast<size_t>(end - pos) < n) return nullptr;
+        const char* bytes = pos;
+        pos += n;
+        return bytes;
+    }
+
+    bool done() const{ return pos == end; }
+
+private:
+    const char* pos;
+    const char* end;
+};
+
+class FrameWriter{
+public:
+    template<class T>
+    void put(const T& value){ putBytes(&value, sizeof(T)); }
+
+    void putBytes(const void* data, size_t n){
+        const char* bytes = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + n);
+    }
+
+    void putColumn(const vector<int>& column){ putBytes(column.data(), column.size() * sizeof(int32_t)); }
+
+    const vector<char>& bytes() const{ return buffer; }
+
+private:
+    vector<char> buffer;
+};
+
+struct ServerRequest{
+    SchedulingPolicy policy = SchedulingPolicy::FCFS;
+    int time_quantum = 0;
+    uint32_t flags = 0;
+    Workload workload;
+    string error; // set when the request can't be run
+};
+
+void putError(FrameWriter& out, const string& message){
+    out.put<uint32_t>(SERVER_BAD_REQUEST);
+    out.put<uint32_t>(static_cast<uint32_t>(message.size()));
+    out.putBytes(message.data(), message.size());
+}
+
+// split a request payload into its requests; false when it isn't a well-formed batch
+bool parseRequests(const vector<char>& payload, vector<ServerRequest>& requests){
+    FrameReader in(payload.data(), payload.size());
+    uint32_t count;
+    if(!in.read(count) || count > payload.size() / 16) return false; // every request takes at least 16 bytes
+    requests.resize(count);
+    for(ServerRequest& request : requests){
+        uint32_t policy, processes;
+        int32_t time_quantum;
+        if(!in.read(policy) || !in.read(time_quantum) || !in.read(request.flags) || !in.read(processes)) return false;
+        const char* columns = in.take(static_cast<size_t>(processes) * 3 * sizeof(int32_t));
+        if(!columns) return false;
+
+        request.time_quantum = time_quantum;
+        if(policy > static_cast<uint32_t>(SchedulingPolicy::MLFQ)){
+            request.error = "unknown policy " + to_string(policy);
+            continue;
+        }
+        request.policy = static_cast<SchedulingPolicy>(policy);
+        int *ids, *arrivals, *bursts;
+        request.workload.resize(processes, ids, arrivals, bursts);
+        size_t column_bytes = static_cast<size_t>(processes) * sizeof(int32_t);
+        memcpy(ids, columns, column_bytes);
+        memcpy(arrivals, columns + column_bytes, column_bytes);
+        memcpy(bursts, columns + 2 * column_bytes, column_bytes);
+    }
+    return in.done();
+}
+
+// simulate one request and write its response
+void runRequest(const ServerRequest& request, const SimulationOptions& options, FrameWriter& out){
+    if(!request.error.empty()) return putError(out, request.error);
+    ProcessTable processes(request.workload);
+    string problem = invalidRun(processes, request.policy, request.time_quantum, options);
+    if(!problem.empty()) return putError(out, problem);
+
+    StreamingMetrics metrics;
+    processes.metrics = &metrics;
+    processes.keep_records = !(request.flags & SERVER_SUMMARY_ONLY);
+    long long total_execution_time = simulateProcesses(processes, request.time_quantum, request.policy, options);
+    double avg_tat = metrics.mean(metrics.total_tat), avg_wt = metrics.mean(metrics.total_wt), avg_rt = metrics.mean(metrics.total_rt);
+    double cpu_efficiency = 100.0 * total_execution_time / max(1LL, total_execution_time + processes.switch_time);
+    if(processes.keep_records){ // fills the turnaround, waiting and response columns
+        float tat, wt, rt, efficiency;
+        calculateMetrics(processes, rt, tat, wt, efficiency, total_execution_time, processes.switch_time);
+    }
+
+    out.put<uint32_t>(SERVER_OK);
+    out.put<int64_t>(metrics.makespan);
+    for(double value : {avg_tat, avg_wt, avg_rt, cpu_efficiency}) out.put(value);
+    uint32_t columns = processes.keep_records ? static_cast<uint32_t>(processes.size()) : 0;
+    out.put(columns);
+    if(columns == 0) return;
+    for(const vector<int>* column : {&processes.start_time, &processes.end_time, &processes.turnaround_time,
+                                     &processes.waiting_time, &processes.response_time}){
+        out.putColumn(*column);
+    }
+}
+
+// read or write exactly n bytes; false on end of stream or error
+bool readFull(int fd, void* data, size_t n){
+    char* pos = static_cast<char*>(data);
+    while(n > 0){
+        ssize_t got = read(fd, pos, n);
+        if(got < 0 && errno == EINTR) continue;
+        if(got <= 0) return false;
+        pos += got;
+        n -= got;
+    }
+    return true;
+}
+
+bool writeFull(int fd, const void* data, size_t n){
+    const char* pos = static_cast<const char*>(data);
+    while(n > 0){
+        ssize_t sent = send(fd, pos, n, MSG_NOSIGNAL); // a client that hung up is an error, not a SIGPIPE
+        if(sent < 0 && errno == EINTR) continue;
+        if(sent <= 0) return false;
+        pos += sent;
+        n -= sent;
+    }
+    return true;
+}
+
+// answer one client's frames in order until it disconnects or sends something malformed (ConnectionThreads closes
+// the socket after)
+void serveConnection(int fd, JobQueue& jobs, const SimulationOptions& options){
+    vector<char> payload;
+    uint32_t length;
+    while(readFull(fd, &length, sizeof(length)) && length <= SERVER_MAX_FRAME_BYTES){
+        payload.resize(length);
+        vector<ServerRequest> requests;
+        if(!readFull(fd, payload.data(), length) || !parseRequests(payload, requests)) break;
+
+        // the batch's requests run on the workers side by side; this thread just waits for the last one
+        vector<FrameWriter> responses(requests.size());
+        mutex done_lock;
+        condition_variable done;
+        size_t remaining = requests.size();
+        for(size_t i = 0; i < requests.size(); ++i){
+            jobs.push([&, i]{
+                runRequest(requests[i], options, responses[i]);
+                lock_guard<mutex> lock(done_lock);
+                if(--remaining == 0) done.notify_one();
+            });
+        }
+        {
+            unique_lock<mutex> lock(done_lock);
+            done.wait(lock, [&]{ return remaining == 0; });
+        }
+
+        FrameWriter frame;
+        size_t response_bytes = sizeof(uint32_t);
+        for(const FrameWriter& response : responses) response_bytes += response.bytes().size();
+        frame.put(static_cast<uint32_t>(response_bytes));
+        frame.put(static_cast<uint32_t>(responses.size()));
+        for(const FrameWriter& response : responses) frame.putBytes(response.bytes().data(), response.bytes().size());
+        if(!writeFull(fd, frame.bytes().data(), frame.bytes().size())) break;
+    }
+}
+
+char server_socket_path[sizeof(sockaddr_un::sun_path)]; // for the signal handler, which can't touch a std::string
+
+extern "C" void stopServer(int){
+    unlink(server_socket_path);
+    _exit(0);
+}
+
+int runServer(const string& socket_path, unsigned workers, const SimulationOptions& options){
+    const uint32_t probe = 1;
+    if(*reinterpret_cast<const unsigned char*>(&probe) != 1){
+        cout << "Error: the server protocol is little-endian and this host is not\n";
+        return 1;
+    }
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if(socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)){
+        cout << "Error: socket path must be 1 to " << sizeof(address.sun_path) - 1 << " characters\n";
+        return 1;
+    }
+    memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    // a socket left behind by a daemon that died is replaced; anything else at the path is left alone
+    struct stat existing;
+    if(lstat(socket_path.c_str(), &existing) == 0){
+        if(!S_ISSOCK(existing.st_mode)){
+            cout << "Error: " << socket_path << " exists and is not a socket\n";
+            return 1;
+        }
+        unlink(socket_path.c_str());
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0 || bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+       listen(listener, SOMAXCONN) != 0){
+        cout << "Error: cannot listen on " << socket_path << ": " << strerror(errno) << "\n";
+        if(listener >= 0) close(listener);
+        return 1;
+    }
+
+    memcpy(server_socket_path, address.sun_path, sizeof(server_socket_path));
+    struct sigaction stop = {};
+    stop.sa_handler = stopServer;
+    sigaction(SIGINT, &stop, nullptr);
+    sigaction(SIGTERM, &stop, nullptr);
+
+    JobQueue jobs(workers > 0 ? workers : thread::hardware_concurrency());
+    ConnectionThreads connections(SERVER_MAX_CONNECTIONS); // declared after jobs, so stopped before it
+    cout << "Listening on " << socket_path << " with " << jobs.size() << " workers" << endl;
+    while(true){
+        int fd = accept(listener, nullptr, nullptr);
+        if(fd < 0){
+            if(errno == EINTR || errno == ECONNABORTED) continue;
+            if(errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM){
+                // out of descriptors or buffers for now, most likely a burst of clients: wait for some to leave
+                this_thread::sleep_for(chrono::milliseconds(100));
+                continue;
+            }
+            cout << "Error: accept failed: " << strerror(errno) << "\n";
+            break;
+        }
+        connections.start(fd, [&](int client){ serveConnection(client, jobs, options); });
+    }
+    connections.stop();
+    close(listener);
+    unlink(socket_path.c_str());
+    return 1;
+}
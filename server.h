@@ -0,0 +1,41 @@
+// Simulation daemon: a long-running process that takes batches of simulation requests over a Unix domain socket
+// and runs them on a pool of worker threads, so a caller such as the web UI pays neither process startup nor
+// text parsing per simulation.
+//
+// Every message is a frame: a uint32 payload length, then the payload. All integers are little-endian and
+// nothing is padded.
+//
+//   request payload   uint32 request count, then per request:
+//                       uint32 policy (SchedulingPolicy), int32 time quantum, uint32 flags, uint32 process count n,
+//                       int32 id[n], int32 arrival[n], int32 burst[n]
+//   response payload  uint32 request count, then per request, in request order:
+//                       uint32 status; when status is SERVER_OK:
+//                         int64 total time, float64 avg turnaround, avg waiting, avg response, CPU efficiency %,
+//                         uint32 n (0 with SERVER_SUMMARY_ONLY), int32 start[n], end[n], turnaround[n],
+//                         waiting[n], response[n]
+//                       otherwise: uint32 message length, then the message
+//
+// A connection carries any number of frames, answered in order. A frame that can't be parsed closes the
+// connection; a request that can't be run gets an error status and the rest of its batch still runs. At most
+// SERVER_MAX_CONNECTIONS clients are served at once; more wait in the listen backlog until one leaves. Engine
+// settings (switch costs, CFS and MLFQ parameters, event queue, cores) come from the daemon's command line.
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "scheduler.h"
+
+#include <cstdint>
+#include <string>
+
+const uint32_t SERVER_SUMMARY_ONLY = 1; // request flag: only the averages, no per-process columns
+const uint32_t SERVER_OK = 0;
+const uint32_t SERVER_BAD_REQUEST = 1;
+const uint32_t SERVER_MAX_FRAME_BYTES = 256u << 20;
+const size_t SERVER_MAX_CONNECTIONS = 256;
+
+// POSIX only: server.cpp isn't built on Windows, where --serve reports that it isn't supported.
+// listen on socket_path until SIGINT or SIGTERM, with workers simulation threads (0 for one per core); returns
+// the exit status
+int runServer(const std::string& socket_path, unsigned workers, const SimulationOptions& options);
+
+#endif // SERVER_H
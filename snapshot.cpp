@@ -0,0 +1,334 @@
+#include "snapshot.h"
+
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+
+const char SNAPSHOT_MAGIC[8] = {'P', 'P', 'S', 'N', 'A', 'P', 'S', 'H'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304; // reads back differently on a host of the other endianness
+
+// Writes the fields of a snapshot in order. Everything it writes is plain data without padding.
+class SnapshotWriter{
+public:
+    explicit SnapshotWriter(ostream& out): out(out) {}
+
+    template<class T>
+    void put(const T& value){ out.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+
+    template<class T>
+    void put(const vector<T>& values){
+        put<uint64_t>(values.size());
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void put(const LatencyHistogram& histogram){
+        auto buckets = histogram.buckets();
+        put<uint64_t>(buckets.size());
+        for(const auto& bucket : buckets){
+            put(bucket.first);
+            put(bucket.second);
+        }
+    }
+
+private:
+    ostream& out;
+};
+
+// Reads the fields back in the same order. Once anything is missing every later get() fails too, so the caller
+// only checks at the end; vector lengths are checked against what is left of the file before allocating.
+class SnapshotReader{
+public:
+    SnapshotReader(istream& in, uint64_t size): in(in), left(size) {}
+
+    template<class T>
+    bool get(T& value){ return take(&value, sizeof(value)); }
+
+    template<class T>
+    bool get(vector<T>& values){
+        uint64_t count = 0;
+        if(!get(count) || count > left / sizeof(T)) return ok = false;
+        values.resize(count);
+        return take(values.data(), count * sizeof(T));
+    }
+
+    bool get(LatencyHistogram& histogram){
+        uint64_t count = 0;
+        if(!get(count)) return false;
+        for(uint64_t i = 0; i < count && ok; ++i){
+            uint32_t index = 0;
+            long long value = 0;
+            if(get(index) && get(value) && !histogram.addBucket(index, value)) ok = false;
+        }
+        return ok;
+    }
+
+    bool good() const{ return ok; }
+    bool atEnd() const{ return left == 0; }
+
+private:
+    istream& in;
+    uint64_t left;
+    bool ok = true;
+
+    bool take(void* data, uint64_t bytes){
+        if(!ok || bytes > left || !in.read(static_cast<char*>(data), bytes)) return ok = false;
+        left -= bytes;
+        return true;
+    }
+};
+
+bool writeSnapshot(const SimulationSnapshot& snapshot, const string& filename){
+    ofstream outfile(filename, ios::binary);
+    if(!outfile) return false;
+    SnapshotWriter out(outfile);
+    outfile.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    out.put(SNAPSHOT_VERSION);
+    out.put(SNAPSHOT_BYTE_ORDER);
+
+    out.put(static_cast<int32_t>(snapshot.policy));
+    out.put(snapshot.time_quantum);
+    out.put(snapshot.time);
+    out.put(snapshot.process_count);
+    out.put(snapshot.workload_hash);
+    out.put(snapshot.next_arrival);
+    out.put(snapshot.current_process);
+    out.put(snapshot.current_slice);
+    out.put(snapshot.slice_start);
+    out.put<uint64_t>(snapshot.pending.size());
+    for(const Event& event : snapshot.pending){
+        out.put(event.event_time);
+        out.put(static_cast<int32_t>(event.type));
+        out.put(event.process);
+    }
+    out.put<uint64_t>(snapshot.device_queues.size());
+    for(const auto& waiting : snapshot.device_queues) out.put(waiting);
+    out.put(snapshot.busy_devices);
+    out.put(snapshot.last_time);
+    out.put(snapshot.total_execution_time);
+    out.put(snapshot.policy_state.ready);
+    out.put(snapshot.policy_state.per_process);
+    out.put(snapshot.policy_state.counters);
+    out.put(snapshot.loaded);
+    out.put(snapshot.left_at);
+    out.put(snapshot.left_core);
+
+    out.put<uint8_t>(snapshot.keep_records);
+    out.put(snapshot.remaining_time);
+    out.put(snapshot.start_time);
+    out.put(snapshot.end_time);
+    out.put(snapshot.next_io);
+    for(long long counter : {snapshot.events, snapshot.switches, snapshot.switch_time, snapshot.cpu_busy_time, snapshot.overlap_time}){
+        out.put(counter);
+    }
+    out.put(snapshot.device_busy_time);
+    out.put<uint8_t>(snapshot.has_metrics);
+    const StreamingMetrics& metrics = snapshot.metrics;
+    for(long long total : {metrics.completed, metrics.total_tat, metrics.total_wt, metrics.total_rt, metrics.makespan}){
+        out.put(total);
+    }
+    out.put(metrics.turnaround);
+    out.put(metrics.waiting);
+    out.put(metrics.response);
+    return static_cast<bool>(outfile);
+}
+
+bool readSnapshot(const string& filename, SimulationSnapshot& snapshot, string& error){
+    ifstream infile(filename, ios::binary | ios::ate);
+    if(!infile){
+        error = "can't open " + filename;
+        return false;
+    }
+    SnapshotReader in(infile, static_cast<uint64_t>(infile.tellg()));
+    infile.seekg(0);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint32_t version = 0, byte_order = 0;
+    if(!in.get(magic) || memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 || !in.get(version) || !in.get(byte_order)){
+        error = filename + " is not a snapshot file";
+        return false;
+    }
+    if(version != SNAPSHOT_VERSION || byte_order != SNAPSHOT_BYTE_ORDER){
+        error = filename + " was written by another version or on a machine of the other endianness";
+        return false;
+    }
+
+    snapshot = SimulationSnapshot();
+    int32_t policy = 0;
+    uint64_t count = 0;
+    in.get(policy);
+    in.get(snapshot.time_quantum);
+    in.get(snapshot.time);
+    in.get(snapshot.process_count);
+    in.get(snapshot.workload_hash);
+    in.get(snapshot.next_arrival);
+    in.get(snapshot.current_process);
+    in.get(snapshot.current_slice);
+    in.get(snapshot.slice_start);
+    bool valid = policy >= 0 && policy < POLICY_COUNT;
+    snapshot.policy = static_cast<SchedulingPolicy>(policy);
+    for(in.get(count); in.good() && count-- > 0;){
+        int32_t time = 0, type = 0, process = 0;
+        in.get(time);
+        in.get(type);
+        in.get(process);
+        valid = valid && type >= static_cast<int32_t>(EventType::COMPLETION) && type <= static_cast<int32_t>(EventType::UNBLOCK);
+        snapshot.pending.emplace_back(time, static_cast<EventType>(type), process);
+    }
+    if(in.get(count) && count <= MAX_IO_DEVICES) snapshot.device_queues.resize(count);
+    else valid = false;
+    for(auto& waiting : snapshot.device_queues) in.get(waiting);
+    in.get(snapshot.busy_devices);
+    in.get(snapshot.last_time);
+    in.get(snapshot.total_execution_time);
+    in.get(snapshot.policy_state.ready);
+    in.get(snapshot.policy_state.per_process);
+    in.get(snapshot.policy_state.counters);
+    in.get(snapshot.loaded);
+    in.get(snapshot.left_at);
+    in.get(snapshot.left_core);
+
+    uint8_t flag = 0;
+    in.get(flag);
+    snapshot.keep_records = flag != 0;
+    in.get(snapshot.remaining_time);
+    in.get(snapshot.start_time);
+    in.get(snapshot.end_time);
+    in.get(snapshot.next_io);
+    for(long long* counter : {&snapshot.events, &snapshot.switches, &snapshot.switch_time, &snapshot.cpu_busy_time, &snapshot.overlap_time}){
+        in.get(*counter);
+    }
+    in.get(snapshot.device_busy_time);
+    in.get(flag);
+    snapshot.has_metrics = flag != 0;
+    StreamingMetrics& metrics = snapshot.metrics;
+    for(long long* total : {&metrics.completed, &metrics.total_tat, &metrics.total_wt, &metrics.total_rt, &metrics.makespan}){
+        in.get(*total);
+    }
+    in.get(metrics.turnaround);
+    in.get(metrics.waiting);
+    in.get(metrics.response);
+    if(!in.good() || !in.atEnd() || !valid){
+        error = filename + " is truncated or corrupt";
+        return false;
+    }
+    return true; // indices are checked against the workload when it is resumed
+}
+
+bool takeSnapshot(const Workload& workload, SchedulingPolicy policy, int time_quantum, long long time,
+                  const SimulationOptions& options, SimulationSnapshot& snapshot, string& error){
+    ProcessTable processes(workload);
+    StreamingMetrics metrics;
+    processes.metrics = &metrics;
+    processes.keep_records = false;
+    unique_ptr<SteppedSimulation> run = startSimulation(processes, time_quantum, policy, options, error);
+    if(!run) return false;
+    run->runUntil(time);
+    run->save(snapshot);
+    return true;
+}
+
+bool parseWhatIfBranches(const string& spec, int default_quantum, vector<WhatIfBranch>& branches, string& error){
+    branches.clear();
+    size_t start = 0;
+    while(start <= spec.size()){
+        size_t comma = spec.find(',', start);
+        if(comma == string::npos) comma = spec.size();
+        WhatIfBranch branch;
+        branch.spec = spec.substr(start, comma - start);
+        size_t plus = branch.spec.find('+');
+        if(plus != string::npos) branch.inject = branch.spec.substr(plus + 1);
+        if(!parsePolicySpec(branch.spec.substr(0, plus), default_quantum, branch.policy, branch.time_quantum) ||
+           (plus != string::npos && branch.inject.empty())){
+            error = "a branch looks like POLICY[:quantum][+workload file], not \"" + branch.spec + "\"";
+            return false;
+        }
+        branches.push_back(branch);
+        start = comma + 1;
+    }
+    return true;
+}
+
+// base followed by every process of extra, arriving offset later
+bool extendWorkload(const Workload& base, const Workload& extra, long long offset, Workload& out, string& error){
+    out = Workload();
+    out.reserve(base.size() + extra.size());
+    out.append(base);
+    IntColumn ids = extra.idColumn(), arrivals = extra.arrivalColumn(), bursts = extra.burstColumn(), nices = extra.niceColumn();
+    IoColumn io = extra.ioColumn();
+    for(size_t i = 0; i < extra.size(); ++i){
+        long long arrival = offset + arrivals[i];
+        if(arrival > numeric_limits<int>::max()){
+            error = "injected process " + to_string(ids[i]) + " would arrive after the last representable time";
+            return false;
+        }
+        int first_burst = bursts[i];
+        for(size_t s = 0; s < io.stepCount(i); ++s) first_burst -= io.begin(i)[s].cpu_time;
+        out.add(ids[i], static_cast<int>(arrival), first_burst, nices.empty() ? 0 : nices[i]);
+        for(size_t s = 0; s < io.stepCount(i); ++s) out.addIoStep(io.begin(i)[s]);
+    }
+    return true;
+}
+
+struct WhatIfResult{
+    string error;
+    long long total_execution_time = 0, switch_time = 0, events = 0;
+    StreamingMetrics metrics;
+    double seconds = 0;
+};
+
+bool runWhatIf(const Workload& workload, const SimulationSnapshot& snapshot, const vector<WhatIfBranch>& branches,
+               const SimulationOptions& options, unsigned threads, string& error){
+    // injected workloads are read up front, so a bad one fails before anything is simulated
+    vector<Workload> extended(branches.size());
+    for(size_t b = 0; b < branches.size(); ++b){
+        if(branches[b].inject.empty()) continue;
+        Workload extra = readProcesses(branches[b].inject, -1);
+        if(extra.empty()){
+            error = "no processes read from " + branches[b].inject;
+            return false;
+        }
+        if(!extendWorkload(workload, extra, snapshot.time, extended[b], error)) return false;
+    }
+
+    vector<WhatIfResult> results(branches.size());
+    WorkStealingPool pool(threads ? threads : thread::hardware_concurrency());
+    pool.run(branches.size(), [&](size_t b){
+        const WhatIfBranch& branch = branches[b];
+        WhatIfResult& result = results[b];
+        auto start = chrono::steady_clock::now();
+        ProcessTable processes(branch.inject.empty() ? workload : extended[b]);
+        processes.metrics = &result.metrics;
+        unique_ptr<SteppedSimulation> run = resumeSimulation(snapshot, processes, branch.time_quantum, branch.policy, options, result.error);
+        if(!run) return;
+        run->runUntil(numeric_limits<long long>::max());
+        result.total_execution_time = run->totalExecutionTime();
+        result.switch_time = processes.switch_time;
+        result.events = processes.events;
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    });
+    for(size_t b = 0; b < branches.size(); ++b){
+        if(!results[b].error.empty()){
+            error = branches[b].spec + ": " + results[b].error;
+            return false;
+        }
+    }
+
+    size_t width = 8;
+    for(const WhatIfBranch& branch : branches) width = max(width, branch.spec.size() + 2);
+    cout << left << setw(width) << "branch" << right << setw(11) << "completed" << setw(12) << "total time"
+         << setw(12) << "avg TAT" << setw(10) << "p99 TAT" << setw(12) << "avg WT" << setw(12) << "avg RT"
+         << setw(10) << "CPU eff%" << setw(12) << "events" << setw(10) << "seconds" << "\n";
+    for(size_t b = 0; b < branches.size(); ++b){
+        const WhatIfResult& result = results[b];
+        const StreamingMetrics& metrics = result.metrics;
+        double efficiency = 100.0 * result.total_execution_time / max(1LL, result.total_execution_time + result.switch_time);
+        cout << left << setw(width) << branches[b].spec << right << setw(11) << metrics.completed
+             << setw(12) << metrics.makespan << fixed << setprecision(2) << setw(12) << metrics.mean(metrics.total_tat)
+             << setw(10) << metrics.turnaround.percentile(99) << setw(12) << metrics.mean(metrics.total_wt)
+             << setw(12) << metrics.mean(metrics.total_rt) << setw(10) << efficiency << setw(12) << result.events
+             << setprecision(3) << setw(10) << result.seconds << "\n";
+        cout.unsetf(ios::floatfield);
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+// Snapshots of single-CPU runs on disk, and what-if runs: one prefix of a simulation, run once and then continued
+// under several alternatives at the same time, e.g. switching from FCFS to RR at t=1000000 next to a burst of 10K
+// extra jobs arriving then. Every branch resumes from the same read-only SimulationSnapshot into run state of its
+// own, so branches run in parallel without locking, each for the cost of copying the snapshot's arrays.
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "scheduler.h"
+
+#include <string>
+#include <vector>
+
+// A snapshot file is "PPSNAPSH", a version and a byte-order mark, then the fields of SimulationSnapshot in
+// declaration order as they are in memory: scalars as is, vectors as a uint64 length followed by their elements,
+// the metric histograms as their non-empty (bucket, count) pairs. It is only read back on the same endianness.
+bool writeSnapshot(const SimulationSnapshot& snapshot, const std::string& filename);
+bool readSnapshot(const std::string& filename, SimulationSnapshot& snapshot, std::string& error);
+
+// Simulate workload under policy up to time and save it: every event before time handled, none after. The run
+// keeps streaming metrics only, no per-process records.
+bool takeSnapshot(const Workload& workload, SchedulingPolicy policy, int time_quantum, long long time,
+                  const SimulationOptions& options, SimulationSnapshot& snapshot, std::string& error);
+
+// one way of carrying on from a snapshot
+struct WhatIfBranch{
+    std::string spec; // as given on the command line, to label its results
+    SchedulingPolicy policy = SchedulingPolicy::FCFS;
+    int time_quantum = 0;
+    std::string inject; // workload file of extra processes arriving that long after the snapshot; empty for none
+};
+
+// comma-separated branches, each POLICY[:quantum][+inject file]
+bool parseWhatIfBranches(const std::string& spec, int default_quantum, std::vector<WhatIfBranch>& branches,
+                         std::string& error);
+
+// Continue snapshot, taken on workload, under every branch, spread over threads (0 for one per core), and print
+// a table of the results. Fails, with error set, when an injected workload can't be read or a branch can't be
+// resumed.
+bool runWhatIf(const Workload& workload, const SimulationSnapshot& snapshot, const std::vector<WhatIfBranch>& branches,
+               const SimulationOptions& options, unsigned threads, std::string& error);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,309 @@
+#include "trace_import.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+using namespace std;
+
+const size_t TRACE_READ_BUFFER = 1 << 20; // bytes read at a time; a longer line is cut off at this length
+
+// what the importer knows about one live task
+struct TraceTask{
+    enum State : uint8_t{RUNNABLE, RUNNING, SLEEPING};
+    State state = RUNNABLE;
+    int nice = 0;
+    long long arrival = 0; // all times in trace nanoseconds
+    long long since = 0; // when it went on the CPU, or to sleep
+    long long burst = 0; // CPU time in the burst so far
+    int first_burst = 0; // in time units, once it has ended
+    bool first_done = false;
+    vector<IoStep> steps; // the last one is the sleep in progress, or awaits its CPU burst
+};
+
+// Builds the workload up as events come in. Tasks are written out when they exit, or at the end of the trace,
+// so only the tasks alive at any moment are held here.
+class TraceReplay{
+public:
+    TraceReplay(const TraceImportOptions& options, Workload& out, TraceImportStats& stats):
+      unit(max(1LL, options.time_unit_ns)), queue_disk_waits(options.queue_disk_waits), out(out), stats(stats) {}
+
+    bool failed() const{ return !error.empty(); }
+    const string& failure() const{ return error; }
+
+    void start(long long time){ if(first_time < 0) first_time = time; last_time = time; }
+
+    void wakeup(int pid, int prio, long long time){
+        if(pid == 0) return; // the idle task
+        TraceTask& task = find(pid, time, prio);
+        if(task.state != TraceTask::SLEEPING) return; // already runnable: a spurious or repeated wakeup
+        wake(task, time);
+    }
+
+    void sched_switch(int prev, int prev_prio, char prev_state, int next, int next_prio, long long time){
+        if(prev != 0){
+            TraceTask& task = find(prev, first_time, prev_prio); // on the CPU from before the trace started
+            if(task.state == TraceTask::RUNNING) task.burst += time - task.since;
+            task.state = TraceTask::RUNNABLE; // preempted, still wants the CPU
+            if(prev_state == 'X' || prev_state == 'Z'){
+                finish(prev, time); // exited
+            }else if(prev_state != 'R'){
+                endBurst(task);
+                task.steps.push_back(IoStep{prev_state == 'D' && queue_disk_waits ? 0 : SLEEP_DEVICE, 0, 0});
+                task.state = TraceTask::SLEEPING;
+                task.since = time;
+            }
+        }
+        if(next != 0){
+            TraceTask& task = find(next, time, next_prio);
+            if(task.state == TraceTask::SLEEPING) wake(task, time); // its wakeup is missing from the trace
+            task.state = TraceTask::RUNNING;
+            task.since = time;
+        }
+    }
+
+    // write out every task still alive when the trace ends, in arrival order
+    void finishAll(){
+        vector<pair<long long, int>> alive;
+        for(const auto& [pid, task] : tasks) alive.emplace_back(task.arrival, pid);
+        sort(alive.begin(), alive.end());
+        for(size_t i = 0; i < alive.size() && !failed(); ++i) finish(alive[i].second, last_time);
+    }
+
+private:
+    long long unit;
+    bool queue_disk_waits;
+    Workload& out;
+    TraceImportStats& stats;
+    unordered_map<int, TraceTask> tasks;
+    unordered_map<int, int> generations; // tasks written out so far under each pid
+    long long first_time = -1, last_time = 0;
+    string error;
+
+    // the task with pid, arriving at time if it is new
+    TraceTask& find(int pid, long long time, int prio){
+        auto [it, added] = tasks.try_emplace(pid);
+        TraceTask& task = it->second;
+        if(added) task.arrival = time;
+        if(prio >= 0) task.nice = prio < 100 ? -20 : min(19, prio - 120); // real-time tasks get the most weight
+        return task;
+    }
+
+    void wake(TraceTask& task, long long time){
+        task.steps.back().io_time = units(time - task.since, 0);
+        task.state = TraceTask::RUNNABLE;
+        task.burst = 0;
+    }
+
+    // the CPU burst in progress is over
+    void endBurst(TraceTask& task){
+        int cpu = units(task.burst, 1);
+        if(!task.first_done) task.first_burst = cpu;
+        else task.steps.back().cpu_time = cpu;
+        task.first_done = true;
+        task.burst = 0;
+    }
+
+    void finish(int pid, long long time){
+        TraceTask& task = tasks[pid];
+        if(task.state == TraceTask::RUNNING) task.burst += time - task.since;
+        if(task.state != TraceTask::SLEEPING && task.burst > 0) endBurst(task);
+        // a sleep (or a wakeup) with no CPU after it is not part of the workload
+        if(!task.steps.empty() && task.steps.back().cpu_time == 0) task.steps.pop_back();
+
+        long long cpu_total = task.first_done ? task.first_burst : 0;
+        for(const IoStep& step : task.steps) cpu_total += step.cpu_time;
+        long long arrival = (task.arrival - first_time) / unit;
+        if(cpu_total > numeric_limits<int>::max() || arrival > numeric_limits<int>::max()){
+            error = "task " + to_string(pid) + " does not fit in an int of time units; use a larger --trace-unit";
+        }else if(task.first_done){
+            // a pid seen again after its earlier task exited is a new task: keep the ids apart
+            int generation = generations[pid]++;
+            long long id = pid + static_cast<long long>(generation) * TRACE_PID_SPAN;
+            if(pid < 0 || pid >= TRACE_PID_SPAN || id > numeric_limits<int>::max()){
+                error = "pid " + to_string(pid) + " is out of range or reused too often to give its tasks ids of their own";
+            }else{
+                out.add(static_cast<int>(id), static_cast<int>(arrival), task.first_burst, task.nice);
+                for(const IoStep& step : task.steps) out.addIoStep(step);
+                ++stats.tasks;
+                if(generation > 0) ++stats.reused_pids;
+                stats.bursts += 1 + task.steps.size();
+            }
+        } // else it never ran: it asked for no CPU within the trace
+        tasks.erase(pid);
+    }
+
+    int units(long long nanoseconds, int at_least){
+        long long rounded = (nanoseconds + unit / 2) / unit;
+        if(rounded > numeric_limits<int>::max()){
+            error = "a burst does not fit in an int of time units; use a larger --trace-unit";
+            return at_least;
+        }
+        return static_cast<int>(max<long long>(at_least, rounded));
+    }
+};
+
+// parse digits at the front of text into value
+bool parseNumber(string_view text, int& value){
+    if(text.empty()) return false;
+    long long parsed = 0;
+    for(char c : text){
+        if(c < '0' || c > '9' || parsed > numeric_limits<int>::max()) return false;
+        parsed = parsed * 10 + (c - '0');
+    }
+    value = static_cast<int>(parsed);
+    return parsed <= numeric_limits<int>::max();
+}
+
+// "seconds.fraction" into nanoseconds
+bool parseTimestamp(string_view text, long long& nanoseconds){
+    size_t dot = text.find('.');
+    int seconds;
+    if(!parseNumber(text.substr(0, dot), seconds)) return false;
+    long long fraction = 0, scale = 1000000000;
+    if(dot != string_view::npos){
+        for(char c : text.substr(dot + 1)){
+            if(c < '0' || c > '9') return false;
+            if(scale > 1){
+                scale /= 10;
+                fraction += (c - '0') * scale;
+            }
+        }
+    }
+    nanoseconds = seconds * 1000000000LL + fraction;
+    return true;
+}
+
+// the value of "key=value" in an event's fields, up to the next space
+string_view fieldValue(string_view fields, string_view key){
+    size_t at = 0;
+    while((at = fields.find(key, at)) != string_view::npos){
+        if(at == 0 || fields[at - 1] == ' '){
+            string_view value = fields.substr(at + key.size());
+            return value.substr(0, value.find(' '));
+        }
+        at += key.size();
+    }
+    return string_view();
+}
+
+// perf's compact form of a task, "comm:pid [prio]" (comm may hold colons and spaces); pid and prio are set from it
+bool parseCompactTask(string_view text, int& pid, int& prio){
+    size_t bracket = text.rfind(" [");
+    if(bracket == string_view::npos) return false;
+    size_t colon = text.rfind(':', bracket);
+    size_t close = text.find(']', bracket);
+    return colon != string_view::npos && close != string_view::npos &&
+           parseNumber(text.substr(colon + 1, bracket - colon - 1), pid) &&
+           parseNumber(text.substr(bracket + 2, close - bracket - 2), prio);
+}
+
+// feed one trace line to replay; lines that aren't scheduler events are skipped
+void parseTraceLine(string_view line, TraceReplay& replay, TraceImportStats& stats){
+    size_t at = line.find("sched_");
+    while(at != string_view::npos && line.compare(at, 13, "sched_switch:") != 0 && line.compare(at, 13, "sched_wakeup:") != 0 &&
+          line.compare(at, 17, "sched_wakeup_new:") != 0){
+        at = line.find("sched_", at + 6);
+    }
+    if(at == string_view::npos) return;
+    bool is_switch = line[at + 6] == 's';
+    string_view fields = line.substr(line.find(':', at) + 1);
+    while(!fields.empty() && fields.front() == ' ') fields.remove_prefix(1);
+
+    // the timestamp is the "seconds.fraction:" token before the event name (perf writes "sched:sched_switch")
+    size_t end = at;
+    if(end >= 6 && line.compare(end - 6, 6, "sched:") == 0) end -= 6;
+    while(end > 0 && line[end - 1] == ' ') --end;
+    if(end == 0 || line[end - 1] != ':') return;
+    size_t begin = --end;
+    while(begin > 0 && line[begin - 1] != ' ') --begin;
+    long long time;
+    if(!parseTimestamp(line.substr(begin, end - begin), time)) return;
+
+    int prev = 0, next = 0, prev_prio = -1, next_prio = -1, pid = 0, prio = -1;
+    char prev_state = 'R';
+    if(is_switch){
+        string_view state;
+        if(!fieldValue(fields, "prev_pid=").empty()){ // ftrace, and perf's raw format
+            if(!parseNumber(fieldValue(fields, "prev_pid="), prev) || !parseNumber(fieldValue(fields, "next_pid="), next)) return;
+            parseNumber(fieldValue(fields, "prev_prio="), prev_prio);
+            parseNumber(fieldValue(fields, "next_prio="), next_prio);
+            state = fieldValue(fields, "prev_state=");
+        }else{ // perf's "prev_comm:pid [prio] S ==> next_comm:pid [prio]"
+            size_t arrow = fields.find(" ==> ");
+            if(arrow == string_view::npos) return;
+            string_view left = fields.substr(0, arrow);
+            size_t close = left.rfind(']');
+            if(close == string_view::npos || !parseCompactTask(left.substr(0, close + 1), prev, prev_prio) ||
+               !parseCompactTask(fields.substr(arrow + 5), next, next_prio)) return;
+            state = left.substr(close + 1);
+            while(!state.empty() && state.front() == ' ') state.remove_prefix(1);
+        }
+        if(!state.empty()) prev_state = state.front();
+    }else{
+        if(!parseNumber(fieldValue(fields, "pid="), pid)){
+            size_t bracket = fields.find(" [");
+            if(bracket == string_view::npos || !parseCompactTask(fields.substr(0, fields.find(']', bracket) + 1), pid, prio)) return;
+        }else{
+            parseNumber(fieldValue(fields, "prio="), prio);
+        }
+    }
+
+    ++stats.events;
+    replay.start(time);
+    if(is_switch) replay.sched_switch(prev, prev_prio, prev_state, next, next_prio, time);
+    else replay.wakeup(pid, prio, time);
+}
+
+bool importSchedTrace(const string& filename, const TraceImportOptions& options, Workload& out, TraceImportStats& stats, string& error){
+    FILE* in = filename == "-" ? stdin : fopen(filename.c_str(), "rb");
+    if(!in){
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    stats = TraceImportStats();
+    out = Workload();
+    TraceReplay replay(options, out, stats);
+    vector<char> buffer(TRACE_READ_BUFFER);
+    size_t held = 0; // bytes of an unfinished line carried over from the last read
+    while(!replay.failed()){
+        size_t got = fread(buffer.data() + held, 1, buffer.size() - held, in);
+        stats.bytes += got;
+        size_t filled = held + got;
+        if(filled == 0) break;
+        const char* pos = buffer.data();
+        const char* end = pos + filled;
+        while(pos < end && !replay.failed()){
+            const char* newline = static_cast<const char*>(memchr(pos, '\n', end - pos));
+            if(!newline){
+                bool overlong = pos == buffer.data() && filled == buffer.size();
+                if(got > 0 && !overlong) break; // finish it after the next read
+                newline = end; // the last line, or one longer than the buffer
+            }
+            ++stats.lines;
+            parseTraceLine(string_view(pos, newline - pos), replay, stats);
+            pos = newline < end ? newline + 1 : end;
+        }
+        held = end - pos;
+        memmove(buffer.data(), pos, held);
+        if(got == 0 && held == 0) break;
+    }
+    bool read_error = ferror(in) != 0;
+    if(in != stdin) fclose(in);
+    if(!replay.failed()) replay.finishAll();
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if(read_error) error = "cannot read " + filename;
+    else if(replay.failed()) error = replay.failure();
+    else if(out.empty()) error = "no sched_switch or sched_wakeup events in " + filename;
+    if(!error.empty()){
+        out = Workload();
+        return false;
+    }
+    return true;
+}
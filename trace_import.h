@@ -0,0 +1,40 @@
+// Workloads from real Linux scheduler traces: the text of `perf sched script` or of an ftrace dump with the
+// sched_switch and sched_wakeup events on. The trace is read one line at a time from a fixed-size buffer, so a
+// trace of any size is imported in memory proportional to the workload it turns into, not to the file.
+#ifndef TRACE_IMPORT_H
+#define TRACE_IMPORT_H
+
+#include "scheduler.h"
+
+#include <cstdint>
+#include <string>
+
+struct TraceImportOptions{
+    long long time_unit_ns = 1000; // one simulator time unit, in trace nanoseconds
+    bool queue_disk_waits = false; // uninterruptible (D state) waits queue on I/O device 0 instead of just sleeping
+};
+
+// Linux never hands out a pid at or above this (pid_max is at most 2^22), so ids from pid + generation * this
+// don't collide
+const int TRACE_PID_SPAN = 1 << 22;
+
+struct TraceImportStats{
+    uint64_t bytes = 0, lines = 0;
+    uint64_t events = 0; // sched_switch and sched_wakeup lines used
+    uint64_t tasks = 0; // processes in the workload
+    uint64_t reused_pids = 0; // tasks that got a pid an earlier task in the trace had exited with
+    uint64_t bursts = 0; // CPU bursts across all of them
+    double seconds = 0;
+};
+
+// Rebuild every task's arrival and CPU/sleep bursts from the trace in filename ("-" for stdin) and fill out with
+// one process per task. A task arrives the first time it wakes up (or runs, if the trace never shows it waking),
+// its CPU bursts are the time it spent on any CPU between sleeps, and each sleep becomes a SLEEP_DEVICE step
+// (see IoStep) as long as the time from going to sleep to its wakeup. Being preempted isn't a sleep: the simulated
+// policy decides that wait again. A task's id is its pid; as pids get reused over a long trace, the task that
+// gets a pid after g earlier ones with it exited is pid + g * TRACE_PID_SPAN, so every process id stays unique.
+// Fails, with error set, when the file can't be read or a time doesn't fit in an int of time_unit_ns units.
+bool importSchedTrace(const std::string& filename, const TraceImportOptions& options, Workload& out,
+                      TraceImportStats& stats, std::string& error);
+
+#endif // TRACE_IMPORT_H